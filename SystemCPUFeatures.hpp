@@ -0,0 +1,324 @@
+/*MIT License
+
+Copyright (c) 2021 CasualYouTuber31 <naysar@protonmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+	defined(_M_IX86)
+	#define _SYSTEM_PROPERTIES_X86
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define _SYSTEM_PROPERTIES_ARM64
+	#ifdef __linux__
+		#include <sys/auxv.h>
+	#endif
+#endif
+
+/**\file  SystemCPUFeatures.hpp
+ * \brief This file declares the header-only detection of the instruction set
+ *        extensions the CPU supports.
+ * \details Detection asks the CPU directly, with \c CPUID on x86 and
+ *          \c getauxval() on ARM Linux, so it never reads \c /proc and doesn't
+ *          need a \c System::Properties object. Include this header on its
+ *          own to check the features once at startup and pick vectorised code
+ *          paths:
+ * \code
+ * static const bool avx2 = System::cpuFeatures().has(System::CPUFeature::AVX2);
+ * \endcode
+ */
+
+namespace System {
+	/**
+	 * \brief   The instruction set extensions which can be detected.
+	 * \details Each value is the index of the feature's bit in
+	 *          \c System::CPUFeatures. x86 features are only reported if the OS
+	 *          also saves the registers they use.
+	 */
+	enum class CPUFeature : std::uint8_t {
+		SSE2,
+		SSE3,
+		SSSE3,
+		SSE41,
+		SSE42,
+		POPCNT,
+		AVX,
+		AVX2,
+		FMA,
+		BMI1,
+		BMI2,
+		AES,
+		PCLMUL,
+		SHA,
+		AVX512F,
+		AVX512DQ,
+		AVX512CD,
+		AVX512BW,
+		AVX512VL,
+		AVX512VNNI,
+		AVX512VBMI,
+		NEON,
+		SVE,
+		SVE2,
+		ARMAES,
+		ARMPMULL,
+		ARMSHA1,
+		ARMSHA2,
+		ARMCRC32,
+		ARMAtomics,
+
+		/**
+		 * \brief The number of features.
+		 */
+		COUNT
+	};
+
+	/**
+	 * \brief  Retrieves the conventional name of a feature.
+	 * \param  feature The feature.
+	 * \return The name, e.g. \c "avx2", or \c "" if it is out of range.
+	 */
+	constexpr const char* name(const System::CPUFeature feature) noexcept {
+		constexpr const char* NAMES[] = { "sse2", "sse3", "ssse3", "sse4.1",
+			"sse4.2", "popcnt", "avx", "avx2", "fma", "bmi1", "bmi2", "aes",
+			"pclmul", "sha", "avx512f", "avx512dq", "avx512cd", "avx512bw",
+			"avx512vl", "avx512vnni", "avx512vbmi", "neon", "sve", "sve2",
+			"aes", "pmull", "sha1", "sha2", "crc32", "atomics" };
+		return feature < System::CPUFeature::COUNT ?
+			NAMES[static_cast<std::size_t>(feature)] : "";
+	}
+
+	/**
+	 * \brief   A set of instruction set extensions.
+	 * \details Every operation is \c constexpr, so required sets can be built
+	 *          at compile time and checked against the detected set with a
+	 *          single comparison:
+	 * \code
+	 * constexpr auto NEEDS = System::CPUFeatures()
+	 *     .with(System::CPUFeature::AVX2).with(System::CPUFeature::BMI2);
+	 * if (System::cpuFeatures().hasAll(NEEDS)) { ... }
+	 * \endcode
+	 */
+	class CPUFeatures {
+	public:
+		/**
+		 * \brief Constructs an empty set.
+		 */
+		constexpr CPUFeatures() noexcept = default;
+
+		/**
+		 * \brief Constructs a set from its bits.
+		 * \param bits Bit \c i is set if \c System::CPUFeature \c i is in the
+		 *             set.
+		 */
+		constexpr explicit CPUFeatures(const std::uint64_t bits) noexcept :
+			_bits(bits) {}
+
+		/**
+		 * \brief  Checks if a feature is in the set.
+		 * \param  feature The feature.
+		 * \return \c TRUE if the feature is in the set.
+		 */
+		constexpr bool has(const System::CPUFeature feature) const noexcept {
+			return (_bits & bit(feature)) != 0;
+		}
+
+		/**
+		 * \brief  Checks if every feature of another set is in this one.
+		 * \param  features The other set.
+		 * \return \c TRUE if \c features is a subset of this set.
+		 */
+		constexpr bool hasAll(const System::CPUFeatures features) const
+			noexcept {
+			return (_bits & features._bits) == features._bits;
+		}
+
+		/**
+		 * \brief  Adds a feature to a copy of the set.
+		 * \param  feature The feature to add.
+		 * \return The new set.
+		 */
+		constexpr System::CPUFeatures with(const System::CPUFeature feature)
+			const noexcept {
+			return System::CPUFeatures(_bits | bit(feature));
+		}
+
+		/**
+		 * \brief  Retrieves the bits of the set.
+		 * \return Bit \c i is set if \c System::CPUFeature \c i is in the set.
+		 */
+		constexpr std::uint64_t bits() const noexcept { return _bits; }
+
+		/**
+		 * \brief  Compares two sets.
+		 * \param  other The other set.
+		 * \return \c TRUE if both sets have the same features.
+		 */
+		constexpr bool operator==(const System::CPUFeatures other) const
+			noexcept {
+			return _bits == other._bits;
+		}
+
+		/**
+		 * \brief  Compares two sets.
+		 * \param  other The other set.
+		 * \return \c TRUE if the sets have different features.
+		 */
+		constexpr bool operator!=(const System::CPUFeatures other) const
+			noexcept {
+			return _bits != other._bits;
+		}
+
+		/**
+		 * \brief   Detects the features of the CPU this thread is running on.
+		 * \details This executes a handful of \c CPUID instructions, or one
+		 *          \c getauxval() call, each time it is called: use
+		 *          \c System::cpuFeatures() to detect them only once.
+		 * \return  The detected features, or an empty set on an unknown
+		 *          architecture.
+		 */
+		static System::CPUFeatures detect() noexcept;
+	private:
+		/**
+		 * \brief  Retrieves the bit of a feature.
+		 * \param  feature The feature.
+		 * \return The bit.
+		 */
+		static constexpr std::uint64_t bit(const System::CPUFeature feature)
+			noexcept {
+			return std::uint64_t(1) << static_cast<unsigned>(feature);
+		}
+
+		/**
+		 * \brief The bits of the set.
+		 */
+		std::uint64_t _bits = 0;
+	};
+
+	/**
+	 * \brief   Retrieves the features of the CPU, detected on first use.
+	 * \details The features are detected once per process, and reading them is
+	 *          safe from any thread.
+	 * \return  The detected features.
+	 */
+	inline const System::CPUFeatures& cpuFeatures() noexcept {
+		static const System::CPUFeatures features =
+			System::CPUFeatures::detect();
+		return features;
+	}
+
+	inline System::CPUFeatures CPUFeatures::detect() noexcept {
+		std::uint64_t bits = 0;
+		const auto set = [&](const System::CPUFeature feature,
+			const bool present) {
+			if (present) bits |= bit(feature);
+		};
+#if defined(_SYSTEM_PROPERTIES_X86)
+		// registers[0..3] are EAX, EBX, ECX and EDX
+		const auto cpuid = [](const unsigned leaf, const unsigned subleaf,
+			unsigned* registers) {
+	#ifdef _MSC_VER
+			int out[4];
+			__cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+			for (int i = 0; i < 4; ++i) {
+				registers[i] = static_cast<unsigned>(out[i]);
+			}
+	#else
+			__cpuid_count(leaf, subleaf, registers[0], registers[1],
+				registers[2], registers[3]);
+	#endif
+		};
+		unsigned r[4] = {};
+		cpuid(0, 0, r);
+		const unsigned maxLeaf = r[0];
+		if (maxLeaf < 1) return System::CPUFeatures();
+		cpuid(1, 0, r);
+		const unsigned ecx1 = r[2], edx1 = r[3];
+		unsigned ebx7 = 0, ecx7 = 0;
+		if (maxLeaf >= 7) {
+			cpuid(7, 0, r);
+			ebx7 = r[1];
+			ecx7 = r[2];
+		}
+		// the OS must save the YMM (and for AVX-512, the opmask and ZMM)
+		// registers on context switches, which XCR0 reports
+		std::uint64_t xcr0 = 0;
+		if (ecx1 & (1u << 27)) {
+	#ifdef _MSC_VER
+			xcr0 = _xgetbv(0);
+	#else
+			unsigned low = 0, high = 0;
+			__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+			xcr0 = (static_cast<std::uint64_t>(high) << 32) | low;
+	#endif
+		}
+		const bool ymm = (xcr0 & 0x6) == 0x6;
+		const bool zmm = ymm && (xcr0 & 0xE0) == 0xE0;
+		using F = System::CPUFeature;
+		set(F::SSE2, edx1 & (1u << 26));
+		set(F::SSE3, ecx1 & (1u << 0));
+		set(F::SSSE3, ecx1 & (1u << 9));
+		set(F::SSE41, ecx1 & (1u << 19));
+		set(F::SSE42, ecx1 & (1u << 20));
+		set(F::POPCNT, ecx1 & (1u << 23));
+		set(F::AES, ecx1 & (1u << 25));
+		set(F::PCLMUL, ecx1 & (1u << 1));
+		set(F::AVX, ymm && (ecx1 & (1u << 28)));
+		set(F::FMA, ymm && (ecx1 & (1u << 12)));
+		set(F::AVX2, ymm && (ebx7 & (1u << 5)));
+		set(F::BMI1, ebx7 & (1u << 3));
+		set(F::BMI2, ebx7 & (1u << 8));
+		set(F::SHA, ebx7 & (1u << 29));
+		set(F::AVX512F, zmm && (ebx7 & (1u << 16)));
+		set(F::AVX512DQ, zmm && (ebx7 & (1u << 17)));
+		set(F::AVX512CD, zmm && (ebx7 & (1u << 28)));
+		set(F::AVX512BW, zmm && (ebx7 & (1u << 30)));
+		set(F::AVX512VL, zmm && (ebx7 & (1u << 31)));
+		set(F::AVX512VBMI, zmm && (ecx7 & (1u << 1)));
+		set(F::AVX512VNNI, zmm && (ecx7 & (1u << 11)));
+#elif defined(_SYSTEM_PROPERTIES_ARM64)
+		using F = System::CPUFeature;
+		// Advanced SIMD is mandatory on AArch64
+		set(F::NEON, true);
+	#ifdef __linux__
+		// the HWCAP_* and HWCAP2_* bits of <asm/hwcap.h>
+		const unsigned long hwcap = getauxval(AT_HWCAP);
+		const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+		set(F::ARMAES, hwcap & (1ul << 3));
+		set(F::ARMPMULL, hwcap & (1ul << 4));
+		set(F::ARMSHA1, hwcap & (1ul << 5));
+		set(F::ARMSHA2, hwcap & (1ul << 6));
+		set(F::ARMCRC32, hwcap & (1ul << 7));
+		set(F::ARMAtomics, hwcap & (1ul << 8));
+		set(F::SVE, hwcap & (1ul << 22));
+		set(F::SVE2, hwcap2 & (1ul << 1));
+	#endif
+#endif
+		return System::CPUFeatures(bits);
+	}
+}
@@ -22,25 +22,292 @@ SOFTWARE.*/
 
 #include "SystemProperties.hpp"
 #include <filesystem>
+#include <fstream>
+#include <array>
+#include <map>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
 
 #ifdef __linux__
-	#include <fstream>
 	#include <sys/sysinfo.h>
+	#include <sys/statvfs.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <time.h>
+	#include <poll.h>
+	#include <sys/eventfd.h>
+	#include <sys/socket.h>
+	#include <linux/netlink.h>
+	#include <sys/syscall.h>
+	#include <ifaddrs.h>
+	#include <arpa/inet.h>
+	#include <sys/utsname.h>
 #endif
 
-std::uint64_t System::convert(const std::uint64_t bytes, const System::Unit unit)
-	noexcept {
-	switch (unit) {
-	case System::Unit::Bytes:
-		return bytes;
-	case System::Unit::KB:
-		return bytes / 1024;
-	case System::Unit::MB:
-		return bytes / 1024 / 1024;
-	case System::Unit::GB:
-		return bytes / 1024 / 1024 / 1024;
-	default:
-		return bytes;
+#if defined(__AVX2__)
+	#define _SYSTEM_PROPERTIES_AVX2
+	#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+	#define _SYSTEM_PROPERTIES_SSE2
+	#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+namespace {
+	/**
+	 * \brief  Removes leading and trailing whitespace from a string.
+	 * \param  str The string to trim.
+	 * \return View of the trimmed string.
+	 */
+	std::string_view trim(std::string_view str) noexcept {
+		const auto first = str.find_first_not_of(" \t\r\n");
+		if (first == std::string_view::npos) return std::string_view();
+		const auto last = str.find_last_not_of(" \t\r\n");
+		return str.substr(first, last - first + 1);
+	}
+
+	/**
+	 * \brief  Counts the trailing zero bits of a non-zero mask.
+	 * \param  mask The mask, which must not be \c 0.
+	 * \return The index of the lowest set bit.
+	 */
+	inline unsigned lowestBit(const unsigned mask) noexcept {
+#ifdef _MSC_VER
+		unsigned long index = 0;
+		_BitScanForward(&index, mask);
+		return static_cast<unsigned>(index);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
+
+	/**
+	 * \brief   Finds the first occurrence of a byte in a string.
+	 * \details This is the scanner every parser of this file splits its text
+	 *          with. Up to 32 (AVX2) or 16 (SSE2) bytes are compared at once,
+	 *          depending on the instruction sets the library is compiled for,
+	 *          and the remainder byte by byte.
+	 * \param   text The string to search.
+	 * \param   byte The byte to find.
+	 * \param   pos  The position to start searching from.
+	 * \return  The position of the byte, or \c std::string_view::npos if it
+	 *          isn't found.
+	 */
+	std::size_t findByte(const std::string_view text, const char byte,
+		const std::size_t pos = 0) noexcept {
+		if (pos >= text.size()) return std::string_view::npos;
+		const char* const begin = text.data();
+		const char* const end = begin + text.size();
+		const char* p = begin + pos;
+#ifdef _SYSTEM_PROPERTIES_AVX2
+		const __m256i wide = _mm256_set1_epi8(byte);
+		for (; end - p >= 32; p += 32) {
+			const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+				_mm256_cmpeq_epi8(_mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(p)), wide)));
+			if (mask) {
+				return static_cast<std::size_t>(p - begin) + lowestBit(mask);
+			}
+		}
+#endif
+#ifdef _SYSTEM_PROPERTIES_SSE2
+		const __m128i narrow = _mm_set1_epi8(byte);
+		for (; end - p >= 16; p += 16) {
+			const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+				_mm_cmpeq_epi8(_mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(p)), narrow)));
+			if (mask) {
+				return static_cast<std::size_t>(p - begin) + lowestBit(mask);
+			}
+		}
+#endif
+		for (; p != end; ++p) {
+			if (*p == byte) return static_cast<std::size_t>(p - begin);
+		}
+		return std::string_view::npos;
+	}
+
+	/**
+	 * \brief  Splits the next field off the front of a string.
+	 * \param  text      The string. It is advanced past the field and its
+	 *                   separator.
+	 * \param  separator The byte which ends the field.
+	 * \return View of the field, which is the whole string if it contains no
+	 *         separator.
+	 */
+	std::string_view nextField(std::string_view& text, const char separator)
+		noexcept {
+		const std::size_t end = findByte(text, separator);
+		const std::string_view field = text.substr(0, end);
+		text = end == std::string_view::npos ? std::string_view() :
+			text.substr(end + 1);
+		return field;
+	}
+
+	/**
+	 * \brief Calls a function for each line of a block of text, without
+	 *        allocating.
+	 * \param text The text to split into lines.
+	 * \param fn   The function to call. It is given a view of each line,
+	 *             without its newline character.
+	 */
+	template<typename Fn>
+	void forEachLine(const std::string_view text, Fn&& fn) {
+		std::size_t pos = 0;
+		while (pos < text.size()) {
+			std::size_t end = findByte(text, '\n', pos);
+			if (end == std::string_view::npos) end = text.size();
+			fn(text.substr(pos, end - pos));
+			pos = end + 1;
+		}
+	}
+
+	/**
+	 * \brief  Parses the unsigned integer at the start of a string.
+	 * \param  str   The string to parse. Leading whitespace is skipped.
+	 * \param  value Receives the parsed integer.
+	 * \return View of the rest of the string after the integer, or an empty
+	 *         view if no integer could be parsed (\c value is then left
+	 *         untouched).
+	 */
+	std::string_view parseUnsigned(std::string_view str, std::uint64_t& value)
+		noexcept {
+		const auto first = str.find_first_not_of(" \t");
+		if (first == std::string_view::npos) return std::string_view();
+		str.remove_prefix(first);
+		const auto res = std::from_chars(str.data(), str.data() + str.size(),
+			value);
+		if (res.ec != std::errc()) return std::string_view();
+		return str.substr(static_cast<std::size_t>(res.ptr - str.data()));
+	}
+
+	/**
+	 * \brief   Reads the entire contents of a file.
+	 * \details procfs and sysfs files report a size of 0, so the file is read
+	 *          until EOF instead of being sized up front.
+	 * \param   path The path of the file to read.
+	 * \return  The contents of the file.
+	 * \throws  std::system_error if the file could not be read.
+	 */
+	std::string readFile(const std::filesystem::path& path) {
+		std::ifstream f(path, std::ios::binary);
+		if (!f.good()) {
+			throw std::system_error(std::error_code(errno,
+				std::system_category()), "Failed to open " + path.string());
+		}
+		std::string text;
+		std::array<char, 65536> buffer;
+		while (f.read(buffer.data(), buffer.size()) || f.gcount() > 0) {
+			text.append(buffer.data(), static_cast<std::size_t>(f.gcount()));
+		}
+		if (f.bad()) {
+			throw std::system_error(std::error_code(EIO, std::system_category()),
+				"Failed to read " + path.string());
+		}
+		return text;
+	}
+
+	/**
+	 * \brief  Reads a single-value sysfs attribute.
+	 * \param  path The path of the attribute.
+	 * \return The trimmed value of the attribute, or an empty string if it
+	 *         could not be read.
+	 */
+	std::string readAttribute(const std::filesystem::path& path) {
+		std::ifstream f(path);
+		std::string value;
+		std::getline(f, value);
+		return std::string(trim(value));
+	}
+
+	/**
+	 * \brief  Reads a hexadecimal sysfs attribute, such as a PCI ID.
+	 * \param  path The path of the attribute.
+	 * \return The value of the attribute, or \c 0 if it could not be read.
+	 */
+	std::uint32_t readHexAttribute(const std::filesystem::path& path) {
+		return static_cast<std::uint32_t>(
+			std::strtoul(readAttribute(path).c_str(), nullptr, 16));
+	}
+
+	/**
+	 * \brief  Formats a PCI ID as four hexadecimal digits.
+	 * \param  id The ID to format.
+	 * \return The formatted ID, e.g. \c "10de".
+	 */
+	std::string hexID(const std::uint16_t id) {
+		static const char digits[] = "0123456789abcdef";
+		std::string ret(4, '0');
+		for (int i = 3, v = id; i >= 0; --i, v >>= 4) ret[i] = digits[v & 0xF];
+		return ret;
+	}
+
+	/**
+	 * \brief   Resolves vendor and device names from a \c pci.ids database.
+	 * \details Only the vendor and device sections of the database are scanned,
+	 *          in a single pass, and only the given devices are resolved.
+	 *          Devices which could not be resolved are left untouched.
+	 * \param   text    The contents of the \c pci.ids database.
+	 * \param   devices The devices to resolve the names of.
+	 */
+	void resolvePCINames(const std::string_view text,
+		std::vector<System::GPUDevice>& devices) {
+		const auto parseID = [](const std::string_view str,
+			std::uint16_t& id) -> bool {
+			if (str.size() < 4) return false;
+			id = 0;
+			for (std::size_t i = 0; i < 4; ++i) {
+				const char c = str[i];
+				int digit;
+				if (c >= '0' && c <= '9') digit = c - '0';
+				else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+				else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+				else return false;
+				id = static_cast<std::uint16_t>((id << 4) | digit);
+			}
+			return true;
+		};
+		bool wantedVendor = false;
+		std::uint16_t vendor = 0;
+		std::size_t pos = 0;
+		while (pos < text.size()) {
+			std::size_t end = findByte(text, '\n', pos);
+			if (end == std::string_view::npos) end = text.size();
+			const std::string_view line = text.substr(pos, end - pos);
+			pos = end + 1;
+			if (line.empty() || line[0] == '#') continue;
+			// the class section follows the vendor section, so we can stop
+			if (line.size() > 1 && line[0] == 'C' && line[1] == ' ') break;
+			std::uint16_t id = 0;
+			if (line[0] != '\t') {
+				wantedVendor = false;
+				if (!parseID(line, id)) continue;
+				vendor = id;
+				for (auto& device : devices) {
+					if (device.vendorID != vendor) continue;
+					wantedVendor = true;
+					device.vendor = std::string(trim(line.substr(4)));
+				}
+			} else if (wantedVendor && (line.size() < 2 || line[1] != '\t')) {
+				if (!parseID(line.substr(1), id)) continue;
+				for (auto& device : devices) {
+					if (device.vendorID != vendor || device.deviceID != id) continue;
+					device.name = std::string(trim(line.substr(5)));
+				}
+			}
+		}
 	}
 }
 
@@ -54,425 +321,4489 @@ std::string System::notation(const System::Unit unit) noexcept {
 		return "MB";
 	case System::Unit::GB:
 		return "GB";
+	case System::Unit::DecimalKB:
+		return "kB (decimal)";
+	case System::Unit::DecimalMB:
+		return "MB (decimal)";
+	case System::Unit::DecimalGB:
+		return "GB (decimal)";
 	default:
 		return "";
 	}
 }
 
-////////////////////////////
-// WINDOWS IMPLEMENTATION //
-////////////////////////////
-#ifdef _WIN32
-// https://docs.microsoft.com/en-us/windows/win32/wmisdk/example--getting-wmi-data-from-the-local-computer
-// this web page was invaluable
+System::CPUInfo System::CPUInfo::parse(const std::string_view text) {
+	System::CPUInfo ret;
+	// step 1: split the text into blocks of fields separated by blank lines
+	Fields block;
+	const auto flush = [&]() {
+		if (block.empty()) return;
+		if (block.count("processor")) {
+			ret._logical.push_back(std::move(block));
+		} else {
+			for (auto& field : block) ret._global.insert(std::move(field));
+		}
+		block = Fields();
+	};
+	std::size_t pos = 0;
+	while (pos < text.size()) {
+		std::size_t end = findByte(text, '\n', pos);
+		if (end == std::string_view::npos) end = text.size();
+		const std::string_view line = text.substr(pos, end - pos);
+		pos = end + 1;
+		const std::size_t colon = findByte(line, ':');
+		if (colon == std::string_view::npos) {
+			if (trim(line).empty()) flush();
+			continue;
+		}
+		block.emplace(std::string(trim(line.substr(0, colon))),
+			std::string(trim(line.substr(colon + 1))));
+	}
+	flush();
 
-System::Properties::Properties() {
-	HRESULT res;
-	
-	// step 1: initialise COM
-	res = CoInitializeEx(NULL, COINIT_MULTITHREADED);
-	if (FAILED(res)) {
-		throw std::system_error(std::error_code(res, std::system_category()),
-			"Failed to initialise COM");
-	}
-
-	// step 2: set general COM security levels
-	res = CoInitializeSecurity(
-		NULL,
-		-1,                          // COM authentication
-		NULL,                        // Authentication services
-		NULL,                        // Reserved
-		RPC_C_AUTHN_LEVEL_DEFAULT,   // Default authentication 
-		RPC_C_IMP_LEVEL_IMPERSONATE, // Default Impersonation  
-		NULL,                        // Authentication info
-		EOAC_NONE,                   // Additional capabilities 
-		NULL                         // Reserved
-	);
-	if (FAILED(res)) {
-		CoUninitialize();
-		throw std::system_error(std::error_code(res, std::system_category()),
-			"Failed to initialise COM security");
-	}
-
-	// step 3: obtain the initial locator to WMI
-	res = CoCreateInstance(CLSID_WbemLocator, NULL, CLSCTX_INPROC_SERVER,
-		IID_IWbemLocator, (LPVOID*)&_pLoc);
-	if (FAILED(res)) {
-		CoUninitialize();
-		throw std::system_error(std::error_code(res, std::system_category()),
-			"Failed to create IWbemLocator object");
-	}
-
-	// step 4: connect to WMI
-	res = _pLoc->ConnectServer(
-		_bstr_t(L"ROOT\\CIMV2"), // Object path of WMI namespace
-		NULL,                    // User name. NULL = current user
-		NULL,                    // User password. NULL = current
-		0,                       // Locale. NULL indicates current
-		NULL,                    // Security flags.
-		0,                       // Authority (for example, Kerberos)
-		0,                       // Context object
-		&_pSvc                   // pointer to IWbemServices proxy
-	);
-	if (FAILED(res)) {
-		_pLoc->Release();
-		CoUninitialize();
-		throw std::system_error(std::error_code(res, std::system_category()),
-			"Failed to create IWbemServices proxy");
-	}
-
-	// step 5: set security levels on the proxy
-	res = CoSetProxyBlanket(
-		_pSvc,                       // Indicates the proxy to set
-		RPC_C_AUTHN_WINNT,           // RPC_C_AUTHN_xxx
-		RPC_C_AUTHZ_NONE,            // RPC_C_AUTHZ_xxx
-		NULL,                        // Server principal name 
-		RPC_C_AUTHN_LEVEL_CALL,      // RPC_C_AUTHN_LEVEL_xxx 
-		RPC_C_IMP_LEVEL_IMPERSONATE, // RPC_C_IMP_LEVEL_xxx
-		NULL,                        // client identity
-		EOAC_NONE                    // proxy capabilities 
-	);
-	if (FAILED(res)) {
-		_pSvc->Release();
-		_pLoc->Release();
-		CoUninitialize();
-		throw std::system_error(std::error_code(res, std::system_category()),
-			"Failed to initialise IWbemServices proxy security");
+	// step 2: group the logical CPUs by package and keep the fields which are
+	// identical across each group
+	std::map<unsigned long, std::vector<std::size_t>> packages;
+	for (std::size_t i = 0; i < ret._logical.size(); ++i) {
+		const auto id = ret._logical[i].find("physical id");
+		packages[id == ret._logical[i].end() ? 0 :
+			std::strtoul(id->second.c_str(), nullptr, 10)].push_back(i);
 	}
+	for (const auto& package : packages) {
+		Fields shared = ret._logical[package.second.front()];
+		for (const auto i : package.second) {
+			const Fields& cpu = ret._logical[i];
+			for (auto field = shared.begin(); field != shared.end();) {
+				const auto other = cpu.find(field->first);
+				if (other == cpu.end() || other->second != field->second) {
+					field = shared.erase(field);
+				} else {
+					++field;
+				}
+			}
+		}
+		ret._packages.push_back(std::move(shared));
+	}
+	return ret;
 }
 
-System::Properties::~Properties() noexcept {
-	if (_pSvc) _pSvc->Release();
-	if (_pLoc) _pLoc->Release();
-	CoUninitialize();
-}
-
-std::variant<std::vector<std::int64_t>, std::vector<std::uint64_t>,
-	std::vector<std::string>> System::Properties::_wmiRequest(
-	const char* className, const char* objectName, const CIMTYPE datatype) {
-	HRESULT res;
-
-	// step 1: construct WMI query string
-	// format: SELECT x FROM y\0
-	std::size_t qryBuffSize = 14 + strlen(className) + strlen(objectName);
-	char* qry = (char*)calloc(qryBuffSize, sizeof(char));
-	strncpy_s(qry, qryBuffSize, "SELECT ", strlen("SELECT "));
-	strncat_s(qry, qryBuffSize, objectName, strlen(objectName));
-	strncat_s(qry, qryBuffSize, " FROM ", strlen(" FROM "));
-	strncat_s(qry, qryBuffSize, className, strlen(className));
-
-	// step 2: use the IWbemServices proxy to make the request to the WMI
-	IEnumWbemClassObject* pEnumerator = NULL;
-	res = _pSvc->ExecQuery(bstr_t("WQL"), bstr_t(qry),
-		WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY, NULL, &pEnumerator);
-	free(qry);
-	if (FAILED(res)) {
-		std::string e = "Failed to perform query for WMI object ";
-		e.append(className);
-		e.append(".");
-		e.append(objectName);
-		throw std::system_error(std::error_code(res, std::system_category()), e);
-	}
-
-	// step 3: get the data from the query's result
-	std::variant<std::vector<std::int64_t>, std::vector<std::uint64_t>,
-		std::vector<std::string>> ret;
-	std::size_t numberOfValues = 0;
-	IWbemClassObject* pclsObj = NULL;
-	ULONG uReturn = 0;
-	while (pEnumerator) {
-		res = pEnumerator->Next(WBEM_INFINITE, 1, &pclsObj, &uReturn);
-		if (!uReturn) break;
-		VARIANT vtProp = VARIANT();
-		wchar_t wtext[500]; // no object name is going to be this long... right?
-		std::size_t unused = 0;
-		mbstowcs_s(&unused, wtext, 500, objectName, strlen(objectName)+1);
-		// unfortunately, retrieving the CIM data type here is not reliable
-		// for example, CIM_Processor.AddressWidth is stored as a number, as this
-		// function says it should be,
-		// but CIM_PhysicalMemory.Capacity is stored as a series of strings, even
-		// though this function says it should be numeric??? this happens with
-		// Win32_LogicalDisk, too. idk man...
-		res = pclsObj->Get(wtext, 0, &vtProp, NULL, 0);
-
-		switch (datatype) {
-		case CIM_STRING:
-			// setup vector
-			if (numberOfValues == 0) ret = std::vector<std::string>();
-
-			{ std::wstring ws(vtProp.bstrVal, SysStringLen(vtProp.bstrVal));
-			int sizeNeeded = WideCharToMultiByte(CP_UTF8, 0, &ws[0],
-				(int)ws.size(), NULL, 0, NULL, NULL);
-			std::get<std::vector<std::string>>(ret).push_back(
-				std::string(sizeNeeded, 0));
-			WideCharToMultiByte(CP_UTF8, 0, &ws[0], (int)ws.size(),
-				&(std::get<std::vector<std::string>>(ret)[numberOfValues])[0],
-				sizeNeeded, NULL, NULL); }
-			break;
-		case CIM_SINT8:
-		case CIM_SINT16:
-		case CIM_SINT32:
-		case CIM_SINT64:
-			// setup vector
-			if (numberOfValues == 0) ret = std::vector<std::int64_t>();
-			std::get<std::vector<std::int64_t>>(ret).push_back(
-				(std::int64_t)vtProp.llVal);
+System::CPUInfo System::CPUInfo::load(const std::filesystem::path& path) {
+	return parse(readFile(path));
+}
+
+std::size_t System::CPUInfo::logicalCount() const noexcept {
+	return _logical.size();
+}
+
+std::size_t System::CPUInfo::packageCount() const noexcept {
+	return _packages.size();
+}
+
+const System::CPUInfo::Fields& System::CPUInfo::logical(
+	const std::size_t index) const {
+	return _logical.at(index);
+}
+
+const System::CPUInfo::Fields& System::CPUInfo::package(
+	const std::size_t index) const {
+	return _packages.at(index);
+}
+
+const System::CPUInfo::Fields& System::CPUInfo::global() const noexcept {
+	return _global;
+}
+
+bool System::MemoryStats::parse(const std::string_view text,
+	System::MemoryStats& stats) noexcept {
+	struct Field {
+		std::string_view key;
+		std::uint64_t System::MemoryStats::* member;
+	};
+	static constexpr Field FIELDS[] = {
+		{ "MemTotal", &System::MemoryStats::total },
+		{ "MemFree", &System::MemoryStats::free },
+		{ "MemAvailable", &System::MemoryStats::available },
+		{ "Buffers", &System::MemoryStats::buffers },
+		{ "Cached", &System::MemoryStats::cached },
+		{ "SwapCached", &System::MemoryStats::swapCached },
+		{ "Active", &System::MemoryStats::active },
+		{ "Inactive", &System::MemoryStats::inactive },
+		{ "SwapTotal", &System::MemoryStats::swapTotal },
+		{ "SwapFree", &System::MemoryStats::swapFree },
+		{ "Dirty", &System::MemoryStats::dirty },
+		{ "Shmem", &System::MemoryStats::shmem },
+		{ "Slab", &System::MemoryStats::slab },
+		{ "SReclaimable", &System::MemoryStats::slabReclaimable },
+		{ "CommitLimit", &System::MemoryStats::commitLimit },
+		{ "Committed_AS", &System::MemoryStats::committed },
+		{ "HugePages_Total", &System::MemoryStats::hugePagesTotal },
+		{ "HugePages_Free", &System::MemoryStats::hugePagesFree },
+		{ "HugePages_Rsvd", &System::MemoryStats::hugePagesReserved },
+		{ "HugePages_Surp", &System::MemoryStats::hugePagesSurplus },
+		{ "Hugepagesize", &System::MemoryStats::hugePageSize },
+		{ "Hugetlb", &System::MemoryStats::hugetlb }
+	};
+	stats = System::MemoryStats();
+	bool foundTotal = false;
+	forEachLine(text, [&](const std::string_view line) {
+		const std::size_t colon = findByte(line, ':');
+		if (colon == std::string_view::npos) return;
+		const std::string_view key = line.substr(0, colon);
+		for (const auto& field : FIELDS) {
+			if (field.key != key) continue;
+			std::uint64_t value = 0;
+			const std::string_view unit = trim(
+				parseUnsigned(line.substr(colon + 1), value));
+			// huge page counts have no unit, everything else is in kB
+			stats.*field.member = unit == "kB" ? value * 1024 : value;
+			if (field.member == &System::MemoryStats::total) foundTotal = true;
 			break;
-		case CIM_UINT8:
-		case CIM_UINT16:
-		case CIM_UINT32:
-		case CIM_UINT64:
-			// setup vector
-			if (numberOfValues == 0) ret = std::vector<std::uint64_t>();
-			std::get<std::vector<std::uint64_t>>(ret).push_back(
-				(std::uint64_t)vtProp.ullVal);
+		}
+	});
+	return foundTotal;
+}
+
+std::vector<System::GPUDevice> System::enumerateGPUs(
+	const std::filesystem::path& sysfs,
+	const std::vector<std::filesystem::path>& pciIDs) {
+	std::vector<System::GPUDevice> ret;
+	std::error_code err;
+	std::filesystem::directory_iterator it(sysfs / "bus" / "pci" / "devices",
+		err);
+	if (err) return ret;
+	for (; it != std::filesystem::directory_iterator(); it.increment(err)) {
+		if (err) break;
+		const std::filesystem::path& dev = it->path();
+		System::GPUDevice gpu;
+		gpu.classCode = readHexAttribute(dev / "class");
+		if ((gpu.classCode >> 16) != 0x03) continue;
+		gpu.address = dev.filename().string();
+		gpu.vendorID = static_cast<std::uint16_t>(readHexAttribute(dev / "vendor"));
+		gpu.deviceID = static_cast<std::uint16_t>(readHexAttribute(dev / "device"));
+		gpu.bootVGA = readAttribute(dev / "boot_vga") == "1";
+		std::error_code linkErr;
+		const auto driver = std::filesystem::read_symlink(dev / "driver", linkErr);
+		if (!linkErr) {
+			gpu.driver = driver.filename().string();
+			// the module name can differ from the driver name
+			auto module = std::filesystem::read_symlink(dev / "driver" / "module",
+				linkErr).filename().string();
+			if (linkErr) module = gpu.driver;
+			gpu.driverVersion = readAttribute(sysfs / "module" / module /
+				"version");
+		}
+		ret.push_back(std::move(gpu));
+	}
+	std::sort(ret.begin(), ret.end(),
+		[](const System::GPUDevice& a, const System::GPUDevice& b) {
+			if (a.bootVGA != b.bootVGA) return a.bootVGA;
+			return a.address < b.address;
+		});
+	if (ret.empty()) return ret;
+
+	for (const auto& db : pciIDs) {
+		std::error_code existsErr;
+		if (!std::filesystem::exists(db, existsErr)) continue;
+		try {
+			resolvePCINames(readFile(db), ret);
 			break;
+		} catch (const std::system_error&) {
+			// fall through to the next database
+		}
+	}
+	for (auto& gpu : ret) {
+		if (gpu.vendor.empty()) gpu.vendor = "0x" + hexID(gpu.vendorID);
+		if (gpu.name.empty()) gpu.name = "0x" + hexID(gpu.deviceID);
+	}
+	return ret;
+}
+
+const std::string* System::CPUInfo::find(const std::string& key) const
+	noexcept {
+	for (const Fields* fields : { _packages.empty() ? nullptr : &_packages[0],
+		_logical.empty() ? nullptr : &_logical[0], &_global }) {
+		if (!fields) continue;
+		const auto field = fields->find(key);
+		if (field != fields->end()) return &field->second;
+	}
+	return nullptr;
+}
+
+namespace {
+	/**
+	 * \brief   The highest ID \c parseCPUList() accepts, plus one.
+	 * \details Linux supports at most 8192 CPUs, so this leaves plenty of
+	 *          headroom whilst stopping a corrupt range like
+	 *          \c "0-4294967295" from filling the memory.
+	 */
+	constexpr std::uint64_t CPU_LIST_LIMIT = 65536;
+
+	/**
+	 * \brief  Parses a Linux CPU list, such as \c "0-3,8-11".
+	 * \param  text The list to parse. Ranges which are reversed, or which go
+	 *               past \c CPU_LIST_LIMIT, are ignored.
+	 * \return The IDs in the list, in ascending order.
+	 */
+	std::vector<std::uint32_t> parseCPUList(std::string_view text) {
+		std::vector<std::uint32_t> ret;
+		text = trim(text);
+		while (!text.empty()) {
+			std::uint64_t first = 0, last = 0;
+			std::string_view rest = parseUnsigned(text, first);
+			if (rest.data() == nullptr) break;
+			last = first;
+			if (!rest.empty() && rest[0] == '-') {
+				rest = parseUnsigned(rest.substr(1), last);
+				if (rest.data() == nullptr) break;
+			}
+			if (first <= last && last < CPU_LIST_LIMIT) {
+				for (std::uint64_t id = first; id <= last; ++id) {
+					ret.push_back(static_cast<std::uint32_t>(id));
+				}
+			}
+			const std::size_t comma = rest.find(',');
+			if (comma == std::string_view::npos) break;
+			text = rest.substr(comma + 1);
+		}
+		std::sort(ret.begin(), ret.end());
+		ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+		return ret;
+	}
+
+	/**
+	 * \brief  Parses a sysfs size, such as \c "32K".
+	 * \param  text The size to parse.
+	 * \return The size, in bytes.
+	 */
+	std::uint64_t parseSize(const std::string_view text) noexcept {
+		std::uint64_t value = 0;
+		const std::string_view unit = trim(parseUnsigned(text, value));
+		if (unit.empty()) return value;
+		switch (unit[0]) {
+		case 'K':
+			return value * 1024;
+		case 'M':
+			return value * 1024 * 1024;
+		case 'G':
+			return value * 1024 * 1024 * 1024;
+		default:
+			return value;
+		}
+	}
+
+	/**
+	 * \brief  Parses a signed integer attribute, such as \c core_id.
+	 * \param  text The attribute's value.
+	 * \return The value, or \c -1 if it could not be parsed.
+	 */
+	std::int32_t parseID(const std::string& text) noexcept {
+		if (text.empty()) return -1;
+		char* end = nullptr;
+		const long value = std::strtol(text.c_str(), &end, 10);
+		return end == text.c_str() ? -1 : static_cast<std::int32_t>(value);
+	}
+}
+
+bool System::CPUList::contains(const std::uint32_t cpu) const noexcept {
+	return std::binary_search(_first, _last, cpu);
+}
+
+System::Topology System::Topology::load(const std::filesystem::path& sysfs) {
+	System::Topology ret;
+	const std::filesystem::path cpuRoot = sysfs / "devices" / "system" / "cpu";
+	const std::filesystem::path nodeRoot = sysfs / "devices" / "system" /
+		"node";
+
+	// step 1: find the online CPUs
+	std::vector<std::uint32_t> cpus = parseCPUList(
+		readAttribute(cpuRoot / "online"));
+	if (cpus.empty()) {
+		std::error_code err;
+		for (std::filesystem::directory_iterator it(cpuRoot, err), end;
+			!err && it != end; it.increment(err)) {
+			const std::string name = it->path().filename().string();
+			if (name.size() < 4 || name.compare(0, 3, "cpu") ||
+				name.find_first_not_of("0123456789", 3) != std::string::npos) {
+				continue;
+			}
+			std::error_code existsErr;
+			if (!std::filesystem::exists(it->path() / "topology", existsErr)) {
+				continue;
+			}
+			cpus.push_back(static_cast<std::uint32_t>(
+				std::strtoul(name.c_str() + 3, nullptr, 10)));
+		}
+		std::sort(cpus.begin(), cpus.end());
+	}
+	if (cpus.empty()) {
+		throw std::system_error(std::error_code(ENODEV, std::system_category()),
+			"Could not find any online CPU in " + cpuRoot.string());
+	}
+	ret._cpus = ret._pack(cpus);
+	const std::size_t slots = cpus.back() + 1;
+	ret._package.assign(slots, -1);
+	ret._core.assign(slots, -1);
+	ret._node.assign(slots, -1);
+	ret._siblings.assign(slots, -1);
+	ret._cpuCaches.assign(slots, -1);
+
+	// step 2: read each CPU's topology and caches, deduplicating the caches by
+	// their level, type and sharing set
+	std::map<std::vector<std::uint32_t>, std::int32_t> siblingLists;
+	std::map<std::tuple<std::uint32_t, int, std::vector<std::uint32_t>>,
+		std::uint32_t> cacheIndex;
+	std::vector<std::vector<std::uint32_t>> cacheSharing;
+	std::vector<std::pair<std::int32_t, std::int32_t>> cores;
+	std::vector<std::int32_t> packages;
+	for (const std::uint32_t cpu : cpus) {
+		const std::filesystem::path dir = cpuRoot / ("cpu" + std::to_string(cpu));
+		ret._package[cpu] = parseID(readAttribute(dir / "topology" /
+			"physical_package_id"));
+		ret._core[cpu] = parseID(readAttribute(dir / "topology" / "core_id"));
+		packages.push_back(ret._package[cpu]);
+		cores.emplace_back(ret._package[cpu], ret._core[cpu]);
+
+		std::vector<std::uint32_t> siblings = parseCPUList(readAttribute(dir /
+			"topology" / "thread_siblings_list"));
+		if (siblings.empty()) siblings.push_back(cpu);
+		const auto sibling = siblingLists.find(siblings);
+		if (sibling == siblingLists.end()) {
+			const std::int32_t list = ret._pack(siblings);
+			siblingLists.emplace(std::move(siblings), list);
+			ret._siblings[cpu] = list;
+		} else {
+			ret._siblings[cpu] = sibling->second;
 		}
 
-		VariantClear(&vtProp);
-		pclsObj->Release();
-		numberOfValues++;
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> own;
+		for (std::uint32_t i = 0;; ++i) {
+			const std::filesystem::path index = dir / "cache" /
+				("index" + std::to_string(i));
+			const std::string level = readAttribute(index / "level");
+			if (level.empty()) break;
+			System::CacheInfo info;
+			info.level = static_cast<std::uint32_t>(std::strtoul(level.c_str(),
+				nullptr, 10));
+			const std::string type = readAttribute(index / "type");
+			if (type == "Data") info.type = System::CacheInfo::Type::Data;
+			else if (type == "Instruction") {
+				info.type = System::CacheInfo::Type::Instruction;
+			}
+			info.size = parseSize(readAttribute(index / "size"));
+			info.lineSize = static_cast<std::uint32_t>(std::strtoul(
+				readAttribute(index / "coherency_line_size").c_str(), nullptr,
+				10));
+			std::vector<std::uint32_t> sharing = parseCPUList(readAttribute(
+				index / "shared_cpu_list"));
+			if (sharing.empty()) sharing.push_back(cpu);
+			auto key = std::make_tuple(info.level, static_cast<int>(info.type),
+				sharing);
+			auto cache = cacheIndex.find(key);
+			if (cache == cacheIndex.end()) {
+				cache = cacheIndex.emplace(std::move(key),
+					static_cast<std::uint32_t>(ret._caches.size())).first;
+				ret._caches.push_back(info);
+				cacheSharing.push_back(std::move(sharing));
+			}
+			own.emplace_back(info.level, cache->second);
+		}
+		std::stable_sort(own.begin(), own.end());
+		std::vector<std::uint32_t> ownIndices;
+		for (const auto& cache : own) ownIndices.push_back(cache.second);
+		ret._cpuCaches[cpu] = ret._pack(ownIndices);
+	}
+	for (const auto& sharing : cacheSharing) {
+		ret._cacheCPUs.push_back(ret._pack(sharing));
 	}
+	std::sort(packages.begin(), packages.end());
+	ret._packageCount = static_cast<std::size_t>(std::unique(packages.begin(),
+		packages.end()) - packages.begin());
+	std::sort(cores.begin(), cores.end());
+	ret._coreCount = static_cast<std::size_t>(std::unique(cores.begin(),
+		cores.end()) - cores.begin());
 
-	pEnumerator->Release();
+	// step 3: read the NUMA nodes, or put every CPU in node 0 if there are none
+	std::vector<std::uint32_t> nodes = parseCPUList(readAttribute(nodeRoot /
+		"online"));
+	if (nodes.empty()) nodes.push_back(0);
+	ret._nodes = ret._pack(nodes);
+	ret._nodeCPUs.assign(nodes.back() + 1, -1);
+	ret._nodeMemory.assign(nodes.back() + 1, 0);
+	for (const std::uint32_t node : nodes) {
+		const std::filesystem::path dir = nodeRoot /
+			("node" + std::to_string(node));
+		std::vector<std::uint32_t> nodeCPUs;
+		std::error_code err;
+		if (std::filesystem::exists(dir, err)) {
+			for (const std::uint32_t cpu : parseCPUList(readAttribute(dir /
+				"cpulist"))) {
+				// the node's list includes offline CPUs
+				if (std::binary_search(cpus.begin(), cpus.end(), cpu)) {
+					nodeCPUs.push_back(cpu);
+				}
+			}
+			// e.g. "Node 0 MemTotal:       32768000 kB"
+			const std::string meminfo = std::filesystem::exists(dir /
+				"meminfo", err) ? readFile(dir / "meminfo") : std::string();
+			forEachLine(meminfo, [&](const std::string_view line) {
+				const std::size_t key = line.find("MemTotal:");
+				if (key == std::string_view::npos) return;
+				std::uint64_t kb = 0;
+				parseUnsigned(line.substr(key + 9), kb);
+				ret._nodeMemory[node] = kb * 1024;
+			});
+		} else {
+			nodeCPUs = cpus;
+		}
+		for (const std::uint32_t cpu : nodeCPUs) {
+			ret._node[cpu] = static_cast<std::int32_t>(node);
+		}
+		ret._nodeCPUs[node] = ret._pack(nodeCPUs);
+	}
 	return ret;
 }
 
-std::string System::Properties::CPUModel() {
-	return std::get<std::vector<std::string>>(
-		_wmiRequest("CIM_Processor", "name", CIM_STRING))[0];
+System::CPUList System::Topology::cpus() const noexcept {
+	return _list(_cpus);
 }
 
-std::string System::Properties::CPUArchitecture() {
-	return std::to_string(std::get<std::vector<std::uint64_t>>(
-		_wmiRequest("CIM_Processor", "addresswidth", CIM_UINT64))[0]);
+std::size_t System::Topology::packageCount() const noexcept {
+	return _packageCount;
 }
 
-std::string System::Properties::RAMTotal(const System::Unit unit) {
-	std::uint64_t total = 0;
-	std::vector<std::string> bars = std::get<std::vector<std::string>>(
-		_wmiRequest("CIM_PhysicalMemory", "capacity", CIM_STRING));
-	for (auto& i : bars) total += std::stoull(i);
-	return std::to_string(System::convert(total, unit)) + System::notation(unit);
+std::size_t System::Topology::coreCount() const noexcept {
+	return _coreCount;
 }
 
-std::string System::Properties::OSName() {
-	return std::get<std::vector<std::string>>(
-		_wmiRequest("Win32_OperatingSystem", "caption", CIM_STRING))[0];
+std::int32_t System::Topology::package(const std::uint32_t cpu) const
+	noexcept {
+	return cpu < _package.size() ? _package[cpu] : -1;
 }
 
-std::string System::Properties::OSVersion() {
-	return std::get<std::vector<std::string>>(
-		_wmiRequest("Win32_OperatingSystem", "version", CIM_STRING))[0];
+std::int32_t System::Topology::core(const std::uint32_t cpu) const noexcept {
+	return cpu < _core.size() ? _core[cpu] : -1;
 }
 
-std::string System::Properties::GPUVendor() {
-	return std::get<std::vector<std::string>>(
-		_wmiRequest("Win32_VideoController", "adaptercompatibility",
-			CIM_STRING))[0];
+std::int32_t System::Topology::node(const std::uint32_t cpu) const noexcept {
+	return cpu < _node.size() ? _node[cpu] : -1;
 }
 
-std::string System::Properties::GPUName() {
-	return std::get<std::vector<std::string>>(
-		_wmiRequest("Win32_VideoController", "name", CIM_STRING))[0];
+System::CPUList System::Topology::threadSiblings(const std::uint32_t cpu)
+	const noexcept {
+	return _list(cpu < _siblings.size() ? _siblings[cpu] : -1);
 }
 
-std::string System::Properties::GPUDriver() {
-	return std::get<std::vector<std::string>>(
-		_wmiRequest("Win32_VideoController", "driverversion", CIM_STRING))[0];
+System::CacheList System::Topology::caches(const std::uint32_t cpu) const
+	noexcept {
+	const System::CPUList list =
+		_list(cpu < _cpuCaches.size() ? _cpuCaches[cpu] : -1);
+	return System::CacheList(list.begin(), list.end());
 }
 
-/* std::string System::Properties::StorageTotal(const System::Unit unit) {
-	std::string total = std::get<std::vector<std::string>>(
-		_wmiRequest("Win32_LogicalDisk", "size", CIM_STRING))[0];
-	return std::to_string(System::convert(std::stoull(total), unit)) +
-		System::notation(unit);
+const System::CacheInfo* System::Topology::cache(const std::uint32_t cpu,
+	const std::uint32_t level, const System::CacheInfo::Type type) const
+	noexcept {
+	for (const std::uint32_t index : caches(cpu)) {
+		const System::CacheInfo& info = _caches[index];
+		if (info.level == level && info.type == type) return &info;
+	}
+	return nullptr;
 }
 
-std::string System::Properties::StorageFree(const System::Unit unit) {
-	std::string total = std::get<std::vector<std::string>>(
-		_wmiRequest("Win32_LogicalDisk", "freespace", CIM_STRING))[0];
-	return std::to_string(System::convert(std::stoull(total), unit)) +
-		System::notation(unit);
-} */
+System::CPUList System::Topology::sharingCache(const std::uint32_t cpu,
+	const std::uint32_t level) const noexcept {
+	for (const std::uint32_t index : caches(cpu)) {
+		const System::CacheInfo& info = _caches[index];
+		if (info.level == level &&
+			info.type != System::CacheInfo::Type::Instruction) {
+			return _list(_cacheCPUs[index]);
+		}
+	}
+	return System::CPUList();
+}
 
-#endif
+std::size_t System::Topology::cacheCount() const noexcept {
+	return _caches.size();
+}
 
-//////////////////////////
-// LINUX IMPLEMENTATION //
-//////////////////////////
-#ifdef __linux__
+const System::CacheInfo& System::Topology::cacheInfo(const std::size_t index)
+	const {
+	return _caches.at(index);
+}
 
-System::Properties::Properties() {}
+System::CPUList System::Topology::cacheCPUs(const std::size_t index) const {
+	return _list(_cacheCPUs.at(index));
+}
 
-System::Properties::~Properties() {}
+System::CPUList System::Topology::nodes() const noexcept {
+	return _list(_nodes);
+}
 
-std::string System::Properties::_cpuRequest(const std::string& objectName) {
-	std::ifstream f("/proc/cpuinfo");
-	std::string ret;
-	if (!f.good()) {
-		throw std::system_error(std::error_code(f.rdstate(),
-			std::system_category()), "Failed to open /proc/cpuinfo");
-	} else {
-		while (f.good()) {
-			std::string line;
-			std::getline(f, line);
-			std::string object = line.substr(0, line.find('\t'));
-			if (object == objectName) {
-				ret = line.substr(line.find(':') + 2);
-				break;
+System::CPUList System::Topology::nodeCPUs(const std::uint32_t node) const
+	noexcept {
+	return _list(node < _nodeCPUs.size() ? _nodeCPUs[node] : -1);
+}
+
+std::uint64_t System::Topology::nodeMemory(const std::uint32_t node) const
+	noexcept {
+	return node < _nodeMemory.size() ? _nodeMemory[node] : 0;
+}
+
+System::CPUList System::Topology::_list(const std::int32_t list) const
+	noexcept {
+	if (list < 0) return System::CPUList();
+	const std::uint32_t* members = _members.data();
+	return System::CPUList(members + _offsets[list],
+		members + _offsets[list + 1]);
+}
+
+std::int32_t System::Topology::_pack(const std::vector<std::uint32_t>& ids) {
+	_members.insert(_members.end(), ids.begin(), ids.end());
+	_offsets.push_back(static_cast<std::uint32_t>(_members.size()));
+	return static_cast<std::int32_t>(_offsets.size() - 2);
+}
+
+std::vector<System::Mount> System::parseMountInfo(const std::string_view text) {
+	// mount points and sources escape whitespace and backslashes as \ooo
+	const auto unescape = [](const std::string_view field) {
+		const auto octal = [&](const std::size_t i) {
+			return i < field.size() && field[i] >= '0' && field[i] <= '7';
+		};
+		std::string ret;
+		ret.reserve(field.size());
+		for (std::size_t i = 0; i < field.size(); ++i) {
+			if (field[i] == '\\' && octal(i + 1) && octal(i + 2) &&
+				octal(i + 3)) {
+				ret += static_cast<char>((field[i + 1] - '0') * 64 +
+					(field[i + 2] - '0') * 8 + (field[i + 3] - '0'));
+				i += 3;
+			} else {
+				ret += field[i];
 			}
 		}
-		if (ret.size() == 0) {
-			std::string errstr = "Could not find CPU info \"" + objectName + "\"";
-			throw std::system_error(std::error_code(f.rdstate(),
-				std::system_category()), errstr);
+		return ret;
+	};
+	std::vector<System::Mount> ret;
+	forEachLine(text, [&](const std::string_view line) {
+		// 36 35 98:0 /root /mnt rw,noatime master:1 - ext3 /dev/root rw
+		std::string_view fields[6];
+		std::string_view rest = line;
+		std::size_t count = 0;
+		while (count < 6 && !rest.empty()) {
+			fields[count++] = nextField(rest, ' ');
 		}
-	}
+		// the optional fields end with a lone "-"
+		while (!rest.empty() && nextField(rest, ' ') != "-") {}
+		if (count < 6 || rest.empty()) return;
+		std::string_view post[2];
+		for (auto& field : post) field = nextField(rest, ' ');
+		System::Mount mount;
+		std::uint64_t major = 0, minor = 0;
+		const std::string_view number = parseUnsigned(fields[2], major);
+		if (!number.empty() && number[0] == ':') {
+			parseUnsigned(number.substr(1), minor);
+		}
+		mount.major = static_cast<std::uint32_t>(major);
+		mount.minor = static_cast<std::uint32_t>(minor);
+		mount.root = unescape(fields[3]);
+		mount.mountPoint = unescape(fields[4]);
+		mount.options = std::string(fields[5]);
+		mount.fsType = std::string(post[0]);
+		mount.source = unescape(post[1]);
+		ret.push_back(std::move(mount));
+	});
 	return ret;
 }
 
-struct utsname System::Properties::_osRequest() {
-	struct utsname sys;
-	if (uname(&sys)) {
-		throw std::system_error(std::error_code(errno, std::system_category()),
-			"Failed to access utsname structure");
+namespace {
+	/**
+	 * \brief   Queries the capacity of a list of mounts.
+	 * \details In parallel mode, up to eight helper threads take mounts from a
+	 *          shared queue. A mount which takes longer than the timeout is
+	 *          marked as timed out, and its thread is abandoned (and replaced, if
+	 *          there are mounts left): a thread stuck in the kernel on a hung
+	 *          network share can't be cancelled, but it no longer holds up the
+	 *          result. Abandoned threads only touch state they share ownership
+	 *          of, so they can safely outlive the call.
+	 * \param   mounts  The mounts to query. Their figures are filled in.
+	 * \param   options Controls how the mounts are queried.
+	 * \param   root    The directory the mount points are relative to.
+	 * \param   query   The platform-specific function which queries one mount
+	 *                  under \c root. It must not throw.
+	 */
+	void queryMounts(std::vector<System::Mount>& mounts,
+		const System::MountOptions& options, const std::filesystem::path& root,
+		void (*query)(System::Mount&, const std::filesystem::path&) noexcept) {
+		if (!options.parallel || mounts.empty()) {
+			for (auto& mount : mounts) query(mount, root);
+			return;
+		}
+		enum class State { Pending, Running, Done };
+		struct Shared {
+			std::mutex mutex;
+			std::condition_variable done;
+			std::vector<System::Mount> mounts;
+			std::filesystem::path root;
+			std::vector<State> states;
+			std::vector<std::chrono::steady_clock::time_point> started;
+			std::size_t next = 0;
+			bool abandoned = false;
+		};
+		auto shared = std::make_shared<Shared>();
+		shared->mounts = mounts;
+		shared->root = root;
+		shared->states.assign(mounts.size(), State::Pending);
+		shared->started.resize(mounts.size());
+		const auto worker = [query](std::shared_ptr<Shared> shared) {
+			std::unique_lock<std::mutex> lock(shared->mutex);
+			while (!shared->abandoned && shared->next < shared->mounts.size()) {
+				const std::size_t i = shared->next++;
+				shared->states[i] = State::Running;
+				shared->started[i] = std::chrono::steady_clock::now();
+				System::Mount mount = shared->mounts[i];
+				lock.unlock();
+				query(mount, shared->root);
+				lock.lock();
+				// a timed out mount has already been reported, so drop the late
+				// result, and this thread's replacement has taken over the queue
+				if (shared->states[i] == State::Done) return;
+				shared->mounts[i] = std::move(mount);
+				shared->states[i] = State::Done;
+				shared->done.notify_all();
+			}
+		};
+		const std::size_t threads = std::min<std::size_t>(8, mounts.size());
+		for (std::size_t i = 0; i < threads; ++i) {
+			std::thread(worker, shared).detach();
+		}
+
+		std::unique_lock<std::mutex> lock(shared->mutex);
+		for (;;) {
+			const auto now = std::chrono::steady_clock::now();
+			bool finished = true;
+			auto wakeUp = std::chrono::steady_clock::time_point::max();
+			for (std::size_t i = 0; i < shared->mounts.size(); ++i) {
+				if (shared->states[i] == State::Done) continue;
+				if (shared->states[i] != State::Running ||
+					options.timeout.count() <= 0) {
+					finished = false;
+					continue;
+				}
+				const auto deadline = shared->started[i] + options.timeout;
+				if (deadline > now) {
+					finished = false;
+					wakeUp = std::min(wakeUp, deadline);
+					continue;
+				}
+				shared->mounts[i].status = System::Mount::Status::TimedOut;
+				shared->mounts[i].error = std::make_error_code(
+					std::errc::timed_out);
+				shared->states[i] = State::Done;
+				if (shared->next < shared->mounts.size()) {
+					std::thread(worker, shared).detach();
+				}
+			}
+			if (finished) break;
+			if (wakeUp == std::chrono::steady_clock::time_point::max()) {
+				shared->done.wait(lock);
+			} else {
+				shared->done.wait_until(lock, wakeUp);
+			}
+		}
+		shared->abandoned = true;
+		mounts = shared->mounts;
+	}
+
+	/**
+	 * \brief  Checks if a filesystem type is a pseudo filesystem without any
+	 *         capacity.
+	 * \param  fsType The filesystem type.
+	 * \return \c TRUE if the type is a known pseudo filesystem.
+	 */
+	bool isPseudoFilesystem(const std::string& fsType) noexcept {
+		static const char* const PSEUDO[] = { "autofs", "binfmt_misc", "bpf",
+			"cgroup", "cgroup2", "configfs", "debugfs", "devpts", "efivarfs",
+			"fusectl", "hugetlbfs", "mqueue", "nsfs", "proc", "pstore",
+			"rpc_pipefs", "securityfs", "selinuxfs", "sysfs", "tracefs" };
+		for (const char* pseudo : PSEUDO) if (fsType == pseudo) return true;
+		return false;
 	}
-	return sys;
 }
 
-std::string System::Properties::_exec(const char* cmd) {
-    std::array<char, 500> buffer;
-    std::string result;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd, "r"), pclose);
-    if (!pipe) {
-		throw std::system_error(std::error_code(2, std::system_category()),
-			"popen() failed whilst calling GPUVendor()");
-    }
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-        result += buffer.data();
-    }
-    return result;
+std::ptrdiff_t System::NetworkUsage::find(const std::string_view name) const
+	noexcept {
+	for (std::size_t i = 0; i < names.size(); ++i) {
+		if (names[i] == name) return static_cast<std::ptrdiff_t>(i);
+	}
+	return -1;
 }
 
-std::string System::Properties::_gpuRequest(const std::string& name) {
-	std::string cmd = "lshw -class Display 2> /dev/null | grep " + name;
-	std::string out = _exec(cmd.c_str());
-	if (out.find(name) == std::string::npos) {
-		std::string e = "Could not obtain GPU " + name + " information from "
-			"lshw";
-		throw std::system_error(std::error_code(1, std::system_category()), e);
+namespace {
+	/**
+	 * \brief  Finds a device in an inventory by its ID.
+	 * \param  ids The IDs of the inventory's devices.
+	 * \param  id  The ID to find.
+	 * \return The index of the first device with that ID, or \c -1 if it
+	 *         isn't listed.
+	 */
+	std::ptrdiff_t findID(const std::vector<std::string>& ids,
+		const std::string_view id) noexcept {
+		for (std::size_t i = 0; i < ids.size(); ++i) {
+			if (ids[i] == id) return static_cast<std::ptrdiff_t>(i);
+		}
+		return -1;
+	}
+
+	/**
+	 * \brief  Checks that an inventory lists at least one device, before an
+	 *         accessor describes its first one.
+	 * \param  ids  The IDs of the inventory's devices.
+	 * \param  what The kind of device, for the error message.
+	 * \throws std::system_error if the inventory is empty.
+	 */
+	void requireDevice(const std::vector<std::string>& ids, const char* what) {
+		if (ids.empty()) {
+			throw std::system_error(std::make_error_code(
+				std::errc::no_such_device), std::string("Could not find ") +
+				what);
+		}
+	}
+
+	/**
+	 * \brief  Names an SMBIOS memory type, which both the firmware tables and
+	 *         WMI report.
+	 * \param  type The type code.
+	 * \return The name of the type, e.g. \c "DDR4", or an empty string if the
+	 *         type is unknown or isn't a kind of DDR.
+	 */
+	std::string memoryTypeName(const std::uint32_t type) {
+		switch (type) {
+		case 0x12: return "DDR";
+		case 0x13: return "DDR2";
+		case 0x14: return "DDR2 FB-DIMM";
+		case 0x18: return "DDR3";
+		case 0x1A: return "DDR4";
+		case 0x1B: return "LPDDR";
+		case 0x1C: return "LPDDR2";
+		case 0x1D: return "LPDDR3";
+		case 0x1E: return "LPDDR4";
+		case 0x22: return "DDR5";
+		case 0x23: return "LPDDR5";
+		default: return std::string();
+		}
 	}
-	std::string line = out.substr(out.find(name) + name.size() + 2);
-	return line.substr(0, line.find("\n"));
 }
 
-std::string System::Properties::CPUModel() {
-	return _cpuRequest("model name");
+std::ptrdiff_t System::GPUInventory::find(const std::string_view id) const
+	noexcept {
+	return findID(ids, id);
 }
 
-std::string System::Properties::CPUArchitecture() {
-	std::string flags = _cpuRequest("flags");
-	if (flags.find(" lm ") != std::string::npos) {
-		return "64";
-	} else {
-		return "32";
+std::ptrdiff_t System::CPUPackageInventory::find(const std::string_view id)
+	const noexcept {
+	return findID(ids, id);
+}
+
+std::ptrdiff_t System::MemoryModuleInventory::find(const std::string_view id)
+	const noexcept {
+	return findID(ids, id);
+}
+
+std::ptrdiff_t System::DiskInventory::find(const std::string_view id) const
+	noexcept {
+	return findID(ids, id);
+}
+
+std::ptrdiff_t System::DiskUsage::find(const std::uint32_t major,
+	const std::uint32_t minor) const noexcept {
+	for (std::size_t i = 0; i < names.size(); ++i) {
+		if (this->major[i] == major && this->minor[i] == minor) {
+			return static_cast<std::ptrdiff_t>(i);
+		}
 	}
+	return -1;
 }
 
-std::string System::Properties::RAMTotal(const System::Unit unit) {
-	struct sysinfo sys;
-	if (sysinfo(&sys)) {
-		throw std::system_error(std::error_code(errno, std::system_category()),
-			"Failed to access sysinfo structure");
+std::ptrdiff_t System::DiskUsage::find(const System::Mount& mount) const
+	noexcept {
+	// anonymous devices, such as tmpfs and btrfs subvolumes, use major 0
+	if (mount.major == 0) return -1;
+	return find(mount.major, mount.minor);
+}
+
+System::Roots System::Roots::under(const std::filesystem::path& prefix) {
+	System::Roots ret;
+	ret.root = prefix;
+	ret.proc = prefix / "proc";
+	ret.sys = prefix / "sys";
+	return ret;
+}
+
+bool System::Roots::live() const noexcept {
+	return root == "/" && proc == "/proc" && sys == "/sys";
+}
+
+std::filesystem::path System::Roots::mountinfo() const {
+	return proc / (live() ? "self" : "1") / "mountinfo";
+}
+
+namespace {
+	/**
+	 * \brief  Converts an ASCII letter to lower case.
+	 * \param  c The character.
+	 * \return The lower case character, or \c c if it isn't an upper case
+	 *         ASCII letter.
+	 */
+	constexpr char lowerASCII(const char c) noexcept {
+		return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+	}
+
+	/**
+	 * \brief  Compares two WMI identifiers, which are case-insensitive.
+	 * \param  a The first identifier.
+	 * \param  b The second identifier.
+	 * \return \c TRUE if the identifiers are equal, ignoring case.
+	 */
+	bool equalsIgnoringCase(const std::string_view a, const std::string_view b)
+		noexcept {
+		if (a.size() != b.size()) return false;
+		for (std::size_t i = 0; i < a.size(); ++i) {
+			if (lowerASCII(a[i]) != lowerASCII(b[i])) return false;
+		}
+		return true;
 	}
-	return std::to_string(System::convert(sys.totalram, unit)) +
-		System::notation(unit);
 }
 
-std::string System::Properties::OSName() {
-	std::string full = _osRequest().sysname;
-	full += " ";
-	full.append(_osRequest().release);
-	return full;
+System::WMITable::WMITable(std::vector<std::string> columns) noexcept :
+	_columns(std::move(columns)) {}
+
+const std::vector<std::string>& System::WMITable::columns() const noexcept {
+	return _columns;
 }
 
-std::string System::Properties::OSVersion() {
-	return _osRequest().version;
+std::size_t System::WMITable::rows() const noexcept {
+	return _columns.empty() ? 0 : _values.size() / _columns.size();
 }
 
-std::string System::Properties::GPUVendor() {
-	static std::string vendor = "";
-	if (vendor == "") vendor = _gpuRequest("vendor");
-	return vendor;
+std::ptrdiff_t System::WMITable::column(const std::string_view property)
+	const noexcept {
+	for (std::size_t i = 0; i < _columns.size(); ++i) {
+		if (equalsIgnoringCase(_columns[i], property)) {
+			return static_cast<std::ptrdiff_t>(i);
+		}
+	}
+	return -1;
 }
 
-std::string System::Properties::GPUName() {
-	static std::string name = "";
-	if (name == "") name = _gpuRequest("product");
-	return name;
+const std::string& System::WMITable::at(const std::size_t row,
+	const std::size_t column) const {
+	if (row >= rows() || column >= _columns.size()) {
+		throw std::out_of_range("WMI table index out of range");
+	}
+	return _values[row * _columns.size() + column];
 }
 
-std::string System::Properties::GPUDriver() {
-	static std::string driver = "";
-	if (driver == "") {
-		// firstly, we find the driver name
-		std::string config = _gpuRequest("configuration");
-		if (config.find("driver=") == std::string::npos) {
-			throw std::system_error(std::error_code(3, std::system_category()),
-				"Driver was not within Display lshw configurations");
-		}
-		std::string driverParam = config.substr(config.find("driver=") + 7);
-		driverParam = driverParam.substr(0, config.find(" "));
-		// secondly, we use that to make a request to modinfo
-		std::string modinfoIn = "modinfo " + driverParam + " 2> /dev/null | grep "
-			"firmware:";
-		std::string modinfoOut = _exec(modinfoIn.c_str());
-		if (modinfoOut == "") {
-			throw std::system_error(std::error_code(4, std::system_category()),
-				"Could not retrieve driver version from modinfo");
-		}
-		
-		modinfoOut = modinfoOut.substr(modinfoOut.find_first_not_of(" \t", 9));
-		driver = modinfoOut.substr(0, modinfoOut.find_last_not_of("\n\r") + 1);
-	}
-	return driver;
-}
-
-/* std::string System::Properties::StorageTotal(const System::Unit unit) {
-	// if at some point in the future I need to not use filesystem for whatever
-	// reason, then check out statvfs() - seems like it can't do total though...
-	return std::to_string(System::convert(std::filesystem::space("/").capacity,
-		unit)) + System::notation(unit);
+const std::string* System::WMITable::find(const std::size_t row,
+	const std::string_view property) const noexcept {
+	const std::ptrdiff_t index = column(property);
+	if (index < 0 || row >= rows()) return nullptr;
+	return &_values[row * _columns.size() + static_cast<std::size_t>(index)];
 }
 
-std::string System::Properties::StorageFree(const System::Unit unit) {
-	return std::to_string(System::convert(std::filesystem::space("/").available,
-		unit)) + System::notation(unit);
-} */
+std::string* System::WMITable::addRow() {
+	const std::size_t first = _values.size();
+	_values.resize(first + _columns.size());
+	return _values.data() + first;
+}
 
-#endif
+System::WMIClient::WMIClient(std::shared_ptr<System::WMIBackend> backend)
+	noexcept : _backend(std::move(backend)) {}
 
-//////////////////////////
-// MACOS IMPLEMENTATION //
-//////////////////////////
-#ifdef __APPLE__
+std::shared_ptr<const System::WMITable> System::WMIClient::select(
+	const std::string_view className,
+	const std::initializer_list<std::string_view> properties) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto cached = _tables.begin();
+	while (cached != _tables.end() &&
+		!equalsIgnoringCase(cached->first, className)) ++cached;
+	std::vector<std::string> columns;
+	if (cached != _tables.end()) {
+		const System::WMITable& table = *cached->second;
+		bool complete = true;
+		for (const std::string_view property : properties) {
+			if (table.column(property) < 0) complete = false;
+		}
+		if (complete) return cached->second;
+		// keep what was asked for before, so that earlier callers still hit
+		columns = table.columns();
+	}
+	for (const std::string_view property : properties) {
+		bool duplicate = false;
+		for (const std::string& column : columns) {
+			if (equalsIgnoringCase(column, property)) duplicate = true;
+		}
+		if (!duplicate) columns.emplace_back(property);
+	}
 
-// macOS-only implementation goes here
+	std::string query = "SELECT ";
+	for (std::size_t i = 0; i < columns.size(); ++i) {
+		if (i) query.append(", ");
+		query.append(columns[i]);
+	}
+	query.append(" FROM ").append(className);
+	auto table = std::make_shared<System::WMITable>(std::move(columns));
+	++_queries;
+	_backend->execQuery(std::string(className), query, *table);
+	if (cached != _tables.end()) {
+		cached->second = table;
+	} else {
+		_tables.emplace_back(std::string(className), table);
+	}
+	return table;
+}
 
-#endif
+void System::WMIClient::invalidate(const std::string_view className)
+	noexcept {
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (auto i = _tables.begin(); i != _tables.end(); ++i) {
+		if (equalsIgnoringCase(i->first, className)) {
+			_tables.erase(i);
+			return;
+		}
+	}
+}
 
-///////////////////////////////////
-// CROSS-PLATFORM IMPLEMENTATION //
-///////////////////////////////////
-std::string System::Properties::StorageTotal(const System::Unit unit) {
-	// if at some point in the future I need to not use filesystem for whatever
-	// reason, then check out statvfs() - seems like it can't do total though...
-	return std::to_string(System::convert(std::filesystem::space("/").capacity,
-		unit)) + System::notation(unit);
+void System::WMIClient::invalidate() noexcept {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_tables.clear();
 }
 
-std::string System::Properties::StorageFree(const System::Unit unit) {
-	return std::to_string(System::convert(std::filesystem::space("/").available,
-		unit)) + System::notation(unit);
-}
\ No newline at end of file
+std::uint64_t System::WMIClient::queries() const noexcept {
+	return _queries;
+}
+
+namespace {
+	/**
+	 * \brief The number of properties in \c System::Property.
+	 */
+	constexpr unsigned PROPERTY_COUNT =
+		static_cast<unsigned>(System::Property::StorageFree) + 1;
+
+	/**
+	 * \brief  Finds a property's bit in a bitmask of properties.
+	 * \param  property The property.
+	 * \return The property's bit.
+	 */
+	constexpr std::uint32_t propertyBit(const System::Property property)
+		noexcept {
+		return 1u << static_cast<unsigned>(property);
+	}
+
+	/**
+	 * \brief Bitmask of every property.
+	 */
+	constexpr std::uint32_t ALL_PROPERTIES = (1u << PROPERTY_COUNT) - 1;
+
+	/**
+	 * \brief   Calls a function with each property of one or more snapshots.
+	 * \details The function is called once per property, in
+	 *          \c System::Property order, with the property and the matching
+	 *          field of every snapshot.
+	 * \param   f         The function to call.
+	 * \param   snapshots The snapshots.
+	 */
+	template<typename F, typename... S>
+	void visitFields(F&& f, S&... snapshots) {
+		f(System::Property::CPUModel, snapshots.CPUModel...);
+		f(System::Property::CPUArchitecture, snapshots.CPUArchitecture...);
+		f(System::Property::RAMTotal, snapshots.RAMTotal...);
+		f(System::Property::OSName, snapshots.OSName...);
+		f(System::Property::OSVersion, snapshots.OSVersion...);
+		f(System::Property::GPUVendor, snapshots.GPUVendor...);
+		f(System::Property::GPUName, snapshots.GPUName...);
+		f(System::Property::GPUDriver, snapshots.GPUDriver...);
+		f(System::Property::StorageTotal, snapshots.StorageTotal...);
+		f(System::Property::StorageFree, snapshots.StorageFree...);
+	}
+
+	/**
+	 * \brief  Names a property, as it is spelled in \c System::Property.
+	 * \param  property The property.
+	 * \return The property's name.
+	 */
+	const char* propertyName(const System::Property property) noexcept {
+		static const char* const NAMES[PROPERTY_COUNT] = { "CPUModel",
+			"CPUArchitecture", "RAMTotal", "OSName", "OSVersion", "GPUVendor",
+			"GPUName", "GPUDriver", "StorageTotal", "StorageFree" };
+		return NAMES[static_cast<unsigned>(property)];
+	}
+
+	/**
+	 * \brief  Counts the bytes needed to encode an integer as a LEB128 varint.
+	 * \param  value The integer.
+	 * \return The number of bytes.
+	 */
+	std::size_t varintSize(std::uint64_t value) noexcept {
+		std::size_t ret = 1;
+		while (value >= 0x80) {
+			value >>= 7;
+			++ret;
+		}
+		return ret;
+	}
+
+	/**
+	 * \brief Appends an integer as a LEB128 varint.
+	 * \param out   The buffer to append to.
+	 * \param value The integer.
+	 */
+	void putVarint(std::string& out, std::uint64_t value) {
+		while (value >= 0x80) {
+			out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<char>(value));
+	}
+
+	/**
+	 * \brief  Reads a LEB128 varint from the start of a buffer.
+	 * \param  data  The buffer. The varint is removed from its start.
+	 * \param  value Receives the integer.
+	 * \return \c TRUE if a varint was read, \c FALSE if it was truncated or
+	 *         too long.
+	 */
+	bool getVarint(std::string_view& data, std::uint64_t& value) noexcept {
+		value = 0;
+		for (unsigned shift = 0; shift < 64; shift += 7) {
+			if (data.empty()) return false;
+			const auto byte = static_cast<std::uint8_t>(data.front());
+			data.remove_prefix(1);
+			value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) return true;
+		}
+		return false;
+	}
+
+	/**
+	 * \brief Appends a string to a JSON document as a quoted string literal.
+	 * \param out  The document.
+	 * \param text The string.
+	 */
+	void putJSONString(std::string& out, const std::string_view text) {
+		static const char HEX[] = "0123456789abcdef";
+		out.push_back('"');
+		for (const char c : text) {
+			if (c == '"' || c == '\\') {
+				out.push_back('\\');
+				out.push_back(c);
+			} else if (static_cast<unsigned char>(c) < 0x20) {
+				out += "\\u00";
+				out.push_back(HEX[(c >> 4) & 0xF]);
+				out.push_back(HEX[c & 0xF]);
+			} else {
+				out.push_back(c);
+			}
+		}
+		out.push_back('"');
+	}
+}
+
+template<typename String>
+bool System::BasicSnapshot<String>::has(const System::Property property) const
+	noexcept {
+	return present & propertyBit(property);
+}
+
+template<typename String>
+void System::BasicSnapshot<String>::set(const System::Property property)
+	noexcept {
+	present |= propertyBit(property);
+}
+
+template<typename String>
+void System::BasicSnapshot<String>::encode(std::string& out) const {
+	// size the body first so that it can be written straight into out
+	std::size_t length = varintSize(present);
+	visitFields([&](const System::Property property, const auto& value) {
+		if (!has(property)) return;
+		if constexpr (std::is_integral_v<std::decay_t<decltype(value)>>) {
+			length += varintSize(value);
+		} else {
+			length += varintSize(value.size()) + value.size();
+		}
+	}, *this);
+	out.reserve(out.size() + 3 + varintSize(length) + length);
+	out.push_back('S');
+	out.push_back('P');
+	out.push_back(static_cast<char>(VERSION));
+	putVarint(out, length);
+	putVarint(out, present);
+	visitFields([&](const System::Property property, const auto& value) {
+		if (!has(property)) return;
+		if constexpr (std::is_integral_v<std::decay_t<decltype(value)>>) {
+			putVarint(out, value);
+		} else {
+			putVarint(out, value.size());
+			out.append(value.data(), value.size());
+		}
+	}, *this);
+}
+
+template<typename String>
+std::string System::BasicSnapshot<String>::json() const {
+	std::string ret = "{\"version\":" + std::to_string(VERSION);
+	visitFields([&](const System::Property property, const auto& value) {
+		if (!has(property)) return;
+		ret += ",\"";
+		ret += propertyName(property);
+		ret += "\":";
+		if constexpr (std::is_integral_v<std::decay_t<decltype(value)>>) {
+			ret += std::to_string(value);
+		} else {
+			putJSONString(ret, value);
+		}
+	}, *this);
+	ret.push_back('}');
+	return ret;
+}
+
+template<typename String>
+std::vector<System::Property> System::BasicSnapshot<String>::diff(
+	const BasicSnapshot& other) const {
+	std::vector<System::Property> ret;
+	visitFields([&](const System::Property property, const auto& mine,
+		const auto& theirs) {
+		if (has(property) != other.has(property) ||
+			(has(property) && mine != theirs)) {
+			ret.push_back(property);
+		}
+	}, *this, other);
+	return ret;
+}
+
+template struct System::BasicSnapshot<std::string>;
+template struct System::BasicSnapshot<std::string_view>;
+
+std::size_t System::decodeSnapshot(const std::string_view data,
+	System::SnapshotView& out) noexcept {
+	if (data.size() < 3 || data[0] != 'S' || data[1] != 'P' || data[2] == 0) {
+		return 0;
+	}
+	std::string_view rest = data.substr(3);
+	std::uint64_t length = 0;
+	if (!getVarint(rest, length) || length > rest.size()) return 0;
+	const std::size_t consumed = data.size() - rest.size() +
+		static_cast<std::size_t>(length);
+	// properties added by later versions follow the ones known here, and are
+	// skipped along with the rest of the body
+	std::string_view body = rest.substr(0, static_cast<std::size_t>(length));
+	std::uint64_t present = 0;
+	if (!getVarint(body, present)) return 0;
+	out = System::SnapshotView();
+	out.present = static_cast<std::uint32_t>(present) & ALL_PROPERTIES;
+	bool ok = true;
+	visitFields([&](const System::Property property, auto& value) {
+		if (!ok || !out.has(property)) return;
+		std::uint64_t number = 0;
+		ok = getVarint(body, number);
+		if (!ok) return;
+		if constexpr (std::is_integral_v<std::decay_t<decltype(value)>>) {
+			value = number;
+		} else {
+			ok = number <= body.size();
+			if (!ok) return;
+			value = body.substr(0, static_cast<std::size_t>(number));
+			body.remove_prefix(static_cast<std::size_t>(number));
+		}
+	}, out);
+	return ok ? consumed : 0;
+}
+
+////////////////////////////
+// WINDOWS IMPLEMENTATION //
+////////////////////////////
+#ifdef _WIN32
+// https://docs.microsoft.com/en-us/windows/win32/wmisdk/example--getting-wmi-data-from-the-local-computer
+// this web page was invaluable
+
+namespace {
+	/**
+	 * \brief The WMI class describing the CPUs.
+	 */
+	constexpr std::string_view WMI_PROCESSOR = "Win32_Processor";
+
+	/**
+	 * \brief The WMI class describing the RAM modules.
+	 */
+	constexpr std::string_view WMI_MEMORY = "Win32_PhysicalMemory";
+
+	/**
+	 * \brief The WMI class describing the OS.
+	 */
+	constexpr std::string_view WMI_OS = "Win32_OperatingSystem";
+
+	/**
+	 * \brief The WMI class describing the GPUs.
+	 */
+	constexpr std::string_view WMI_VIDEO = "Win32_VideoController";
+
+	/**
+	 * \brief The WMI class describing the disks.
+	 */
+	constexpr std::string_view WMI_DISK = "Win32_DiskDrive";
+
+	/**
+	 * \brief  Converts a UTF-16 string to UTF-8.
+	 * \param  text   The string.
+	 * \param  length The number of characters in the string.
+	 * \return The converted string.
+	 */
+	std::string narrow(const wchar_t* text, const int length) {
+		if (length <= 0) return std::string();
+		const int size = WideCharToMultiByte(CP_UTF8, 0, text, length, NULL, 0,
+			NULL, NULL);
+		std::string ret(size, 0);
+		WideCharToMultiByte(CP_UTF8, 0, text, length, &ret[0], size, NULL,
+			NULL);
+		return ret;
+	}
+
+	/**
+	 * \brief  Converts a UTF-8 string to UTF-16.
+	 * \param  text The string.
+	 * \return The converted string.
+	 */
+	std::wstring widen(const std::string_view text) {
+		if (text.empty()) return std::wstring();
+		const int size = MultiByteToWideChar(CP_UTF8, 0, text.data(),
+			(int)text.size(), NULL, 0);
+		std::wstring ret(size, 0);
+		MultiByteToWideChar(CP_UTF8, 0, text.data(), (int)text.size(), &ret[0],
+			size);
+		return ret;
+	}
+
+	/**
+	 * \brief  Converts the value of a WMI property to a UTF-8 string.
+	 * \param  value The value.
+	 * \return The converted value, or an empty string if it is \c NULL or
+	 *         can't be converted.
+	 */
+	std::string wmiString(VARIANT& value) {
+		// the CIM type of a property isn't reliable: CIM_Processor.AddressWidth
+		// is a number, as documented, but CIM_PhysicalMemory.Capacity and
+		// Win32_LogicalDisk.Size are strings, so every value is converted to
+		// a string and parsed by the caller instead
+		if (value.vt == VT_BSTR) {
+			return narrow(value.bstrVal, (int)SysStringLen(value.bstrVal));
+		}
+		if (value.vt == VT_NULL || value.vt == VT_EMPTY) return std::string();
+		VARIANT converted;
+		VariantInit(&converted);
+		std::string ret;
+		if (SUCCEEDED(VariantChangeType(&converted, &value, VARIANT_ALPHABOOL,
+			VT_BSTR))) {
+			ret = narrow(converted.bstrVal,
+				(int)SysStringLen(converted.bstrVal));
+		}
+		VariantClear(&converted);
+		return ret;
+	}
+
+	/**
+	 * \brief   Executes WQL queries through an \c IWbemServices proxy
+	 *          connected to \c ROOT\\CIMV2.
+	 * \details Every COM call is made on a thread owned by the backend, which
+	 *          joins the multithreaded apartment for as long as the backend
+	 *          lives. The proxy therefore never crosses an apartment, whatever
+	 *          apartment the caller is in, or whether it initialised COM at
+	 *          all, and it is released on the thread which created it.\n
+	 *          Nothing is started until the first query, so programs which
+	 *          never read a WMI property never start COM.
+	 */
+	class WbemBackend : public System::WMIBackend {
+	public:
+		/**
+		 * \brief Stops the COM thread, which releases the connection.
+		 */
+		~WbemBackend() noexcept override {
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stopping = true;
+			}
+			_wake.notify_all();
+			if (_thread.joinable()) _thread.join();
+		}
+
+		void execQuery(const std::string& className, const std::string& query,
+			System::WMITable& out) override {
+			std::unique_lock<std::mutex> lock(_mutex);
+			if (!_thread.joinable()) {
+				_thread = std::thread(&WbemBackend::_run, this);
+			}
+			_wake.wait(lock, [&]() { return !_request; });
+			Request request{ className, query, out, nullptr };
+			_request = &request;
+			_wake.notify_all();
+			_wake.wait(lock, [&]() { return request.done; });
+			if (request.error) std::rethrow_exception(request.error);
+		}
+	private:
+		/**
+		 * \brief A query handed to the COM thread.
+		 */
+		struct Request {
+			/**
+			 * \brief The name of the class being queried.
+			 */
+			const std::string& className;
+
+			/**
+			 * \brief The WQL query.
+			 */
+			const std::string& query;
+
+			/**
+			 * \brief The table to add the instances to.
+			 */
+			System::WMITable& out;
+
+			/**
+			 * \brief The error the query failed with, if it failed.
+			 */
+			std::exception_ptr error;
+
+			/**
+			 * \brief \c TRUE once the COM thread has finished the query.
+			 */
+			bool done = false;
+		};
+
+		/**
+		 * \brief The loop the COM thread runs until the backend is destroyed.
+		 */
+		void _run() noexcept {
+			// step 1: initialise COM
+			const HRESULT com = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+			std::unique_lock<std::mutex> lock(_mutex);
+			for (;;) {
+				_wake.wait(lock, [&]() { return _stopping || _request; });
+				if (!_request) break;
+				Request& request = *_request;
+				lock.unlock();
+				try {
+					if (FAILED(com)) {
+						throw std::system_error(std::error_code(com,
+							std::system_category()),
+							"Failed to initialise COM");
+					}
+					if (!_pSvc) _connect();
+					_query(request.className, request.query, request.out);
+				} catch (...) {
+					request.error = std::current_exception();
+				}
+				lock.lock();
+				request.done = true;
+				_request = nullptr;
+				_wake.notify_all();
+			}
+			lock.unlock();
+			_disconnect();
+			if (SUCCEEDED(com)) CoUninitialize();
+		}
+
+		/**
+		 * \brief  Executes a query, on the COM thread.
+		 * \param  className The name of the class being queried.
+		 * \param  query     The WQL query.
+		 * \param  out       The table to add the instances to.
+		 * \throws std::system_error if the query failed.
+		 */
+		void _query(const std::string& className, const std::string& query,
+			System::WMITable& out) {
+			IEnumWbemClassObject* pEnumerator = NULL;
+			HRESULT res = _pSvc->ExecQuery(bstr_t("WQL"),
+				bstr_t(query.c_str()),
+				WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY, NULL,
+				&pEnumerator);
+			if (FAILED(res)) {
+				throw std::system_error(std::error_code(res,
+					std::system_category()),
+					"Failed to perform query for WMI class " + className);
+			}
+
+			// the property names are converted once per query, rather than
+			// once per value
+			std::vector<std::wstring> names;
+			for (const std::string& column : out.columns()) {
+				names.push_back(widen(column));
+			}
+			IWbemClassObject* pclsObj = NULL;
+			ULONG uReturn = 0;
+			for (;;) {
+				res = pEnumerator->Next(WBEM_INFINITE, 1, &pclsObj, &uReturn);
+				if (FAILED(res) || !uReturn) break;
+				std::string* row = out.addRow();
+				for (std::size_t i = 0; i < names.size(); ++i) {
+					VARIANT vtProp;
+					VariantInit(&vtProp);
+					if (SUCCEEDED(pclsObj->Get(names[i].c_str(), 0, &vtProp,
+						NULL, NULL))) {
+						row[i] = wmiString(vtProp);
+					}
+					VariantClear(&vtProp);
+				}
+				pclsObj->Release();
+			}
+			pEnumerator->Release();
+			if (FAILED(res)) {
+				throw std::system_error(std::error_code(res,
+					std::system_category()),
+					"Failed to enumerate WMI class " + className);
+			}
+		}
+
+		/**
+		 * \brief  Connects to WMI, on the COM thread.
+		 * \throws std::system_error if the connection failed. The next query
+		 *         tries again.
+		 */
+		void _connect() {
+			HRESULT res;
+
+			// step 2: set general COM security levels, which can only be done
+			// once per process: if the host, or another System::Properties,
+			// already did it, the levels it chose are kept
+			res = CoInitializeSecurity(
+				NULL,
+				-1,                          // COM authentication
+				NULL,                        // Authentication services
+				NULL,                        // Reserved
+				RPC_C_AUTHN_LEVEL_DEFAULT,   // Default authentication 
+				RPC_C_IMP_LEVEL_IMPERSONATE, // Default Impersonation  
+				NULL,                        // Authentication info
+				EOAC_NONE,                   // Additional capabilities 
+				NULL                         // Reserved
+			);
+			if (FAILED(res) && res != RPC_E_TOO_LATE) {
+				throw std::system_error(std::error_code(res,
+					std::system_category()),
+					"Failed to initialise COM security");
+			}
+
+			// step 3: obtain the initial locator to WMI
+			res = CoCreateInstance(CLSID_WbemLocator, NULL,
+				CLSCTX_INPROC_SERVER, IID_IWbemLocator, (LPVOID*)&_pLoc);
+			if (FAILED(res)) {
+				_pLoc = NULL;
+				throw std::system_error(std::error_code(res,
+					std::system_category()),
+					"Failed to create IWbemLocator object");
+			}
+
+			// step 4: connect to WMI
+			res = _pLoc->ConnectServer(
+				_bstr_t(L"ROOT\\CIMV2"), // Object path of WMI namespace
+				NULL,                    // User name. NULL = current user
+				NULL,                    // User password. NULL = current
+				0,                       // Locale. NULL indicates current
+				0,                       // Security flags.
+				0,                       // Authority (for example, Kerberos)
+				0,                       // Context object
+				&_pSvc                   // pointer to IWbemServices proxy
+			);
+			if (FAILED(res)) {
+				_disconnect();
+				throw std::system_error(std::error_code(res,
+					std::system_category()),
+					"Failed to create IWbemServices proxy");
+			}
+
+			// step 5: set security levels on the proxy
+			res = CoSetProxyBlanket(
+				_pSvc,                       // Indicates the proxy to set
+				RPC_C_AUTHN_WINNT,           // RPC_C_AUTHN_xxx
+				RPC_C_AUTHZ_NONE,            // RPC_C_AUTHZ_xxx
+				NULL,                        // Server principal name 
+				RPC_C_AUTHN_LEVEL_CALL,      // RPC_C_AUTHN_LEVEL_xxx 
+				RPC_C_IMP_LEVEL_IMPERSONATE, // RPC_C_IMP_LEVEL_xxx
+				NULL,                        // client identity
+				EOAC_NONE                    // proxy capabilities 
+			);
+			if (FAILED(res)) {
+				_disconnect();
+				throw std::system_error(std::error_code(res,
+					std::system_category()),
+					"Failed to initialise IWbemServices proxy security");
+			}
+		}
+
+		/**
+		 * \brief Releases the connection, or a partially made one.
+		 */
+		void _disconnect() noexcept {
+			if (_pSvc) _pSvc->Release();
+			if (_pLoc) _pLoc->Release();
+			_pSvc = NULL;
+			_pLoc = NULL;
+		}
+
+		/**
+		 * \brief Guards \c _request and \c _stopping.
+		 */
+		std::mutex _mutex;
+
+		/**
+		 * \brief Signals a new request, a finished request, or the backend
+		 *        stopping.
+		 */
+		std::condition_variable _wake;
+
+		/**
+		 * \brief The query the COM thread should run next, or \c nullptr.
+		 */
+		Request* _request = nullptr;
+
+		/**
+		 * \brief \c TRUE if the COM thread should exit.
+		 */
+		bool _stopping = false;
+
+		/**
+		 * \brief The thread every COM call is made on, which is started by the
+		 *        first query.
+		 */
+		std::thread _thread;
+
+		/**
+		 * \brief Pointer to the WMI locator. Only the COM thread uses it.
+		 */
+		IWbemLocator* _pLoc = NULL;
+
+		/**
+		 * \brief Pointer to the WMI services. Only the COM thread uses it.
+		 */
+		IWbemServices* _pSvc = NULL;
+	};
+
+	/**
+	 * \brief  Retrieves the CPUs, with every property the accessors read.
+	 * \param  wmi The client to query.
+	 * \return The table of CPUs.
+	 */
+	std::shared_ptr<const System::WMITable> processors(System::WMIClient& wmi) {
+		return wmi.select(WMI_PROCESSOR, { "DeviceID", "Name", "Manufacturer",
+			"NumberOfCores", "NumberOfLogicalProcessors", "AddressWidth" });
+	}
+
+	/**
+	 * \brief  Retrieves the RAM modules, with every property the accessors
+	 *         read.
+	 * \param  wmi The client to query.
+	 * \return The table of RAM modules.
+	 */
+	std::shared_ptr<const System::WMITable> physicalMemory(
+		System::WMIClient& wmi) {
+		return wmi.select(WMI_MEMORY, { "DeviceLocator", "BankLabel",
+			"Capacity", "Speed", "SMBIOSMemoryType", "Manufacturer",
+			"PartNumber" });
+	}
+
+	/**
+	 * \brief  Retrieves the OS, with every property the accessors read.
+	 * \param  wmi The client to query.
+	 * \return The table holding the OS.
+	 */
+	std::shared_ptr<const System::WMITable> operatingSystems(
+		System::WMIClient& wmi) {
+		return wmi.select(WMI_OS, { "Caption", "Version" });
+	}
+
+	/**
+	 * \brief  Retrieves the GPUs, with every property the accessors read.
+	 * \param  wmi The client to query.
+	 * \return The table of GPUs.
+	 */
+	std::shared_ptr<const System::WMITable> videoControllers(
+		System::WMIClient& wmi) {
+		return wmi.select(WMI_VIDEO, { "PNPDeviceID", "AdapterCompatibility",
+			"Name", "DriverVersion" });
+	}
+
+	/**
+	 * \brief  Retrieves the disks, with every property the accessors read.
+	 * \param  wmi The client to query.
+	 * \return The table of disks.
+	 */
+	std::shared_ptr<const System::WMITable> diskDrives(
+		System::WMIClient& wmi) {
+		return wmi.select(WMI_DISK, { "DeviceID", "Model", "Size",
+			"MediaType" });
+	}
+
+	/**
+	 * \brief  Retrieves a property of an instance in a table.
+	 * \param  table    The table.
+	 * \param  row      The index of the instance.
+	 * \param  property The name of the property.
+	 * \return The value, or an empty string if it wasn't selected.
+	 */
+	std::string wmiValue(const System::WMITable& table, const std::size_t row,
+		const std::string_view property) {
+		const std::string* value = table.find(row, property);
+		return value ? *value : std::string();
+	}
+
+	/**
+	 * \brief  Retrieves a numeric property of an instance in a table.
+	 * \param  table    The table.
+	 * \param  row      The index of the instance.
+	 * \param  property The name of the property.
+	 * \return The value, or \c 0 if it is \c NULL or wasn't selected.
+	 */
+	std::uint64_t wmiNumber(const System::WMITable& table,
+		const std::size_t row, const std::string_view property) {
+		const std::string* value = table.find(row, property);
+		return value ? std::strtoull(value->c_str(), nullptr, 10) : 0;
+	}
+
+	/**
+	 * \brief  Retrieves a property of the first instance in a table.
+	 * \param  table    The table.
+	 * \param  property The name of the property.
+	 * \return The value.
+	 * \throws std::system_error if the table is empty.
+	 */
+	std::string firstValue(const System::WMITable& table,
+		const std::string_view property) {
+		const std::string* value = table.find(0, property);
+		if (!value) {
+			throw std::system_error(std::error_code(ERROR_NOT_FOUND,
+				std::system_category()),
+				"WMI returned no instance with property " +
+				std::string(property));
+		}
+		return *value;
+	}
+}
+
+System::Properties::Properties(const System::Roots& roots) : _roots(roots),
+	_wmi(std::make_shared<WbemBackend>()) {}
+
+System::Properties::~Properties() noexcept {
+	// queued prefetches and subscriptions may still be using the WMI services
+	_stopWatching();
+	_workers.stop();
+}
+
+std::string System::Properties::CPUModel() {
+	return _cached(_cpuModel, [&]() {
+		const auto packages = cpuPackages();
+		requireDevice(packages->ids, "a CPU");
+		return packages->models.front();
+	});
+}
+
+std::string System::Properties::CPUArchitecture() {
+	return _cached(_cpuArchitecture, [&]() {
+		return firstValue(*processors(_wmi), "AddressWidth");
+	});
+}
+
+std::uint64_t System::Properties::RAMTotalBytes() {
+	return _cached(_ramTotal, [&]() {
+		std::uint64_t total = 0;
+		for (const std::uint64_t size : memoryModules()->sizes) total += size;
+		return total;
+	});
+}
+
+std::string System::Properties::OSName() {
+	return _cached(_osName, [&]() {
+		return firstValue(*operatingSystems(_wmi), "Caption");
+	});
+}
+
+std::string System::Properties::OSVersion() {
+	return _cached(_osVersion, [&]() {
+		return firstValue(*operatingSystems(_wmi), "Version");
+	});
+}
+
+std::shared_ptr<const System::GPUInventory> System::Properties::gpus() {
+	return _cached(_gpus, [&]() {
+		const auto table = videoControllers(_wmi);
+		System::GPUInventory ret;
+		for (std::size_t i = 0; i < table->rows(); ++i) {
+			ret.ids.push_back(wmiValue(*table, i, "PNPDeviceID"));
+			ret.vendors.push_back(wmiValue(*table, i, "AdapterCompatibility"));
+			ret.names.push_back(wmiValue(*table, i, "Name"));
+			ret.driverVersions.push_back(wmiValue(*table, i, "DriverVersion"));
+		}
+		return std::make_shared<const System::GPUInventory>(std::move(ret));
+	});
+}
+
+std::shared_ptr<const System::CPUPackageInventory>
+	System::Properties::cpuPackages() {
+	return _cached(_cpuPackages, [&]() {
+		const auto table = processors(_wmi);
+		System::CPUPackageInventory ret;
+		for (std::size_t i = 0; i < table->rows(); ++i) {
+			ret.ids.push_back(wmiValue(*table, i, "DeviceID"));
+			ret.models.push_back(wmiValue(*table, i, "Name"));
+			ret.vendors.push_back(wmiValue(*table, i, "Manufacturer"));
+			ret.cores.push_back(static_cast<std::uint32_t>(
+				wmiNumber(*table, i, "NumberOfCores")));
+			ret.threads.push_back(static_cast<std::uint32_t>(
+				wmiNumber(*table, i, "NumberOfLogicalProcessors")));
+		}
+		return std::make_shared<const System::CPUPackageInventory>(
+			std::move(ret));
+	});
+}
+
+std::shared_ptr<const System::MemoryModuleInventory>
+	System::Properties::memoryModules() {
+	return _cached(_memoryModules, [&]() {
+		const auto table = physicalMemory(_wmi);
+		System::MemoryModuleInventory ret;
+		for (std::size_t i = 0; i < table->rows(); ++i) {
+			ret.ids.push_back(wmiValue(*table, i, "DeviceLocator"));
+			ret.banks.push_back(wmiValue(*table, i, "BankLabel"));
+			ret.sizes.push_back(wmiNumber(*table, i, "Capacity"));
+			ret.speeds.push_back(static_cast<std::uint32_t>(
+				wmiNumber(*table, i, "Speed")));
+			ret.types.push_back(memoryTypeName(static_cast<std::uint32_t>(
+				wmiNumber(*table, i, "SMBIOSMemoryType"))));
+			ret.manufacturers.push_back(wmiValue(*table, i, "Manufacturer"));
+			ret.partNumbers.push_back(wmiValue(*table, i, "PartNumber"));
+		}
+		return std::make_shared<const System::MemoryModuleInventory>(
+			std::move(ret));
+	});
+}
+
+std::shared_ptr<const System::DiskInventory> System::Properties::disks() {
+	return _cached(_disks, [&]() {
+		const auto table = diskDrives(_wmi);
+		System::DiskInventory ret;
+		for (std::size_t i = 0; i < table->rows(); ++i) {
+			const std::string media = wmiValue(*table, i, "MediaType");
+			ret.ids.push_back(wmiValue(*table, i, "DeviceID"));
+			ret.models.push_back(wmiValue(*table, i, "Model"));
+			ret.sizes.push_back(wmiNumber(*table, i, "Size"));
+			ret.removable.push_back(media.compare(0, 9, "Removable") == 0 ||
+				media.compare(0, 8, "External") == 0);
+		}
+		return std::make_shared<const System::DiskInventory>(std::move(ret));
+	});
+}
+
+namespace {
+	/**
+	 * \brief Queries the capacity of a drive with \c GetDiskFreeSpaceExA().
+	 * \param mount The drive to query.
+	 */
+	void statMount(System::Mount& mount, const std::filesystem::path&)
+		noexcept {
+		ULARGE_INTEGER available, total, free;
+		if (!GetDiskFreeSpaceExA(mount.mountPoint.c_str(), &available, &total,
+			&free)) {
+			mount.status = System::Mount::Status::Failed;
+			mount.error = std::error_code(GetLastError(), std::system_category());
+			return;
+		}
+		mount.total = total.QuadPart;
+		mount.free = free.QuadPart;
+		mount.available = available.QuadPart;
+		mount.status = System::Mount::Status::OK;
+	}
+
+	/**
+	 * \brief  Describes a drive, without querying its capacity.
+	 * \param  root The root of the drive, e.g. \c "C:\\".
+	 * \return The drive's metadata.
+	 */
+	System::Mount describeDrive(const std::string& root) {
+		System::Mount mount;
+		mount.mountPoint = root;
+		mount.source = root;
+		char fsName[MAX_PATH + 1] = {};
+		if (GetVolumeInformationA(root.c_str(), NULL, 0, NULL, NULL, NULL,
+			fsName, MAX_PATH + 1)) {
+			mount.fsType = fsName;
+		}
+		return mount;
+	}
+}
+
+std::vector<System::Mount> System::enumerateMounts(
+	const System::MountOptions& options, const std::filesystem::path&,
+	const std::filesystem::path& root) {
+	char drives[512] = {};
+	const DWORD length = GetLogicalDriveStringsA(sizeof(drives) - 1, drives);
+	if (length == 0 || length >= sizeof(drives)) {
+		throw std::system_error(std::error_code(GetLastError(),
+			std::system_category()), "Failed to enumerate logical drives");
+	}
+	std::vector<System::Mount> ret;
+	for (const char* drive = drives; *drive; drive += strlen(drive) + 1) {
+		ret.push_back(describeDrive(drive));
+	}
+	queryMounts(ret, options, root, &statMount);
+	return ret;
+}
+
+System::Mount System::mountOf(const std::filesystem::path& path,
+	const System::MountOptions& options, const std::filesystem::path&,
+	const std::filesystem::path& root) {
+	const std::string drive = std::filesystem::canonical(path).root_path()
+		.string();
+	std::vector<System::Mount> ret = { describeDrive(drive) };
+	queryMounts(ret, options, root, &statMount);
+	return ret.front();
+}
+
+void System::Properties::_watch() noexcept {
+	auto tick = std::chrono::steady_clock::now();
+	std::unique_lock<std::mutex> lock(_watchMutex);
+	for (;;) {
+		const auto interval = std::chrono::milliseconds(_pollInterval.load());
+		_watchWake.wait_until(lock, tick + interval,
+			[&]() { return _watchStopping || _watchPending; });
+		if (_watchStopping) break;
+		_watchPending = false;
+		// Windows has no cheap change signal wired up, so only the volatile
+		// properties are re-probed, once per interval
+		std::uint32_t invalidated = 0;
+		if (std::chrono::steady_clock::now() >= tick + interval) {
+			tick = std::chrono::steady_clock::now();
+			invalidated |= propertyBit(System::Property::StorageFree);
+		}
+		lock.unlock();
+		try {
+			_notify(invalidated);
+		} catch (...) {
+			// the probes report their own failures through the snapshot
+		}
+		lock.lock();
+	}
+}
+
+#endif
+
+//////////////////////////
+// LINUX IMPLEMENTATION //
+//////////////////////////
+#ifdef __linux__
+
+System::Properties::Properties(const System::Roots& roots) : _roots(roots) {}
+
+System::Properties::~Properties() {
+	_stopWatching();
+}
+
+std::string System::Properties::_cpuRequest(const std::string& objectName) {
+	const auto snapshot = CPUSnapshot();
+	const std::string* ret = snapshot->find(objectName);
+	if (!ret || ret->empty()) {
+		std::string errstr = "Could not find CPU info \"" + objectName + "\"";
+		throw std::system_error(std::error_code(ENODATA, std::system_category()),
+			errstr);
+	}
+	return *ret;
+}
+
+std::shared_ptr<const System::CPUInfo> System::Properties::CPUSnapshot() {
+	std::lock_guard<std::mutex> lock(_cpuInfoMutex);
+	if (!_cpuInfo) {
+		_cpuInfo = std::make_shared<const System::CPUInfo>(
+			System::CPUInfo::load(_roots.proc / "cpuinfo"));
+	}
+	return _cpuInfo;
+}
+
+void System::Properties::refreshCPUSnapshot() {
+	auto snapshot = std::make_shared<const System::CPUInfo>(
+		System::CPUInfo::load(_roots.proc / "cpuinfo"));
+	{
+		std::lock_guard<std::mutex> lock(_cpuInfoMutex);
+		_cpuInfo = std::move(snapshot);
+	}
+	_cpuPackages.reset();
+	_cpuModel.reset();
+	_cpuArchitecture.reset();
+}
+
+bool System::OSIdentity::kernelAtLeast(const std::uint32_t major,
+	const std::uint32_t minor, const std::uint32_t patch) const noexcept {
+	return std::tie(kernelMajor, kernelMinor, kernelPatch) >=
+		std::tie(major, minor, patch);
+}
+
+void System::OSIdentity::parseOSRelease(const std::string_view text,
+	System::OSIdentity& identity) {
+	const std::pair<std::string_view, std::string System::OSIdentity::*>
+		KEYS[] = { { "NAME", &System::OSIdentity::name },
+		{ "ID", &System::OSIdentity::id },
+		{ "VERSION_ID", &System::OSIdentity::versionID },
+		{ "ID_LIKE", &System::OSIdentity::idLike },
+		{ "PRETTY_NAME", &System::OSIdentity::prettyName } };
+	forEachLine(text, [&](const std::string_view line) {
+		// KEY=value, KEY="value" or KEY='value', with shell-style escapes
+		std::string_view rest = trim(line);
+		if (rest.empty() || rest[0] == '#') return;
+		const std::string_view key = nextField(rest, '=');
+		const auto field = std::find_if(std::begin(KEYS), std::end(KEYS),
+			[&](const auto& k) { return k.first == key; });
+		if (field == std::end(KEYS)) return;
+		std::string value;
+		const char quote = !rest.empty() && (rest[0] == '"' ||
+			rest[0] == '\'') ? rest[0] : '\0';
+		if (quote) rest.remove_prefix(1);
+		for (std::size_t i = 0; i < rest.size() && rest[i] != quote; ++i) {
+			if (rest[i] == '\\' && quote != '\'' && i + 1 < rest.size()) ++i;
+			value += rest[i];
+		}
+		identity.*field->second = std::move(value);
+	});
+}
+
+std::shared_ptr<const System::OSIdentity> System::Properties::OSDetails() {
+	return _cached(_osDetails, [&]() {
+		struct utsname sys;
+		if (uname(&sys)) {
+			throw std::system_error(std::error_code(errno,
+				std::system_category()), "Failed to access utsname structure");
+		}
+		System::OSIdentity identity;
+		identity.sysname = sys.sysname;
+		identity.release = sys.release;
+		identity.version = sys.version;
+		identity.machine = sys.machine;
+		if (!_roots.live()) {
+			// uname() describes the running kernel, so read the other tree's
+			// copy of its fields instead (procfs doesn't report the machine)
+			const std::filesystem::path kernel = _roots.proc / "sys" /
+				"kernel";
+			const auto copy = [&](std::string& field, const char* file) {
+				const std::string text = readFile(kernel / file);
+				field = std::string(trim(text));
+			};
+			copy(identity.sysname, "ostype");
+			copy(identity.release, "osrelease");
+			copy(identity.version, "version");
+		}
+		// e.g. "6.1.0-18-amd64" or "5.15.0"
+		std::uint64_t major = 0, minor = 0, patch = 0;
+		std::string_view rest = parseUnsigned(identity.release, major);
+		if (!rest.empty() && rest[0] == '.') {
+			rest = parseUnsigned(rest.substr(1), minor);
+			if (!rest.empty() && rest[0] == '.') {
+				parseUnsigned(rest.substr(1), patch);
+			}
+		}
+		identity.kernelMajor = static_cast<std::uint32_t>(major);
+		identity.kernelMinor = static_cast<std::uint32_t>(minor);
+		identity.kernelPatch = static_cast<std::uint32_t>(patch);
+		for (const auto& path : { _roots.root / "etc" / "os-release",
+			_roots.root / "usr" / "lib" / "os-release" }) {
+			std::error_code err;
+			if (!std::filesystem::exists(path, err)) continue;
+			System::OSIdentity::parseOSRelease(readFile(path), identity);
+			break;
+		}
+		return std::make_shared<const System::OSIdentity>(
+			std::move(identity));
+	});
+}
+
+std::shared_ptr<const System::GPUInventory> System::Properties::gpus() {
+	return _cached(_gpus, [&]() {
+		const std::vector<System::GPUDevice> devices = System::enumerateGPUs(
+			_roots.sys, {
+				_roots.root / "usr" / "share" / "hwdata" / "pci.ids",
+				_roots.root / "usr" / "share" / "misc" / "pci.ids",
+				_roots.root / "usr" / "share" / "pci.ids" });
+		System::GPUInventory ret;
+		for (const auto& gpu : devices) {
+			ret.ids.push_back(gpu.address);
+			ret.vendors.push_back(gpu.vendor);
+			ret.names.push_back(gpu.name);
+			// in-tree modules are versioned with the kernel they were built
+			// with
+			if (gpu.driver.empty()) {
+				ret.driverVersions.emplace_back();
+			} else if (gpu.driverVersion.empty()) {
+				ret.driverVersions.push_back(OSDetails()->release);
+			} else {
+				ret.driverVersions.push_back(gpu.driverVersion);
+			}
+		}
+		return std::make_shared<const System::GPUInventory>(std::move(ret));
+	});
+}
+
+std::shared_ptr<const System::CPUPackageInventory>
+	System::Properties::cpuPackages() {
+	return _cached(_cpuPackages, [&]() {
+		const auto snapshot = CPUSnapshot();
+		// group the logical CPUs by package, in the order CPUInfo numbers the
+		// packages
+		std::map<std::uint64_t, std::vector<const System::CPUInfo::Fields*>>
+			packages;
+		for (std::size_t i = 0; i < snapshot->logicalCount(); ++i) {
+			const System::CPUInfo::Fields& cpu = snapshot->logical(i);
+			const auto id = cpu.find("physical id");
+			std::uint64_t package = 0;
+			if (id != cpu.end()) parseUnsigned(id->second, package);
+			packages[package].push_back(&cpu);
+		}
+		System::CPUPackageInventory ret;
+		std::size_t index = 0;
+		for (const auto& package : packages) {
+			const System::CPUInfo::Fields& shared = snapshot->package(index++);
+			const auto field = [&](const char* key) {
+				const auto value = shared.find(key);
+				return value == shared.end() ? std::string() : value->second;
+			};
+			std::vector<std::string_view> cores;
+			for (const System::CPUInfo::Fields* cpu : package.second) {
+				const auto core = cpu->find("core id");
+				if (core != cpu->end() && std::find(cores.begin(), cores.end(),
+					core->second) == cores.end()) cores.push_back(core->second);
+			}
+			const auto threads = static_cast<std::uint32_t>(
+				package.second.size());
+			ret.ids.push_back(std::to_string(package.first));
+			ret.models.push_back(field("model name"));
+			ret.vendors.push_back(field("vendor_id"));
+			ret.cores.push_back(cores.empty() ? threads :
+				static_cast<std::uint32_t>(cores.size()));
+			ret.threads.push_back(threads);
+		}
+		return std::make_shared<const System::CPUPackageInventory>(
+			std::move(ret));
+	});
+}
+
+std::shared_ptr<const System::MemoryModuleInventory>
+	System::Properties::memoryModules() {
+	return _cached(_memoryModules, [&]() {
+		return std::make_shared<const System::MemoryModuleInventory>(
+			System::enumerateMemoryModules(_roots.sys));
+	});
+}
+
+std::shared_ptr<const System::DiskInventory> System::Properties::disks() {
+	return _cached(_disks, [&]() {
+		return std::make_shared<const System::DiskInventory>(
+			System::enumerateDisks(_roots.sys));
+	});
+}
+
+std::string System::Properties::CPUModel() {
+	return _cached(_cpuModel, [&]() { return _cpuRequest("model name"); });
+}
+
+std::string System::Properties::CPUArchitecture() {
+	return _cached(_cpuArchitecture, [&]() -> std::string {
+		// pad the flags so that "lm" is found even if it is the first or last
+		// flag
+		std::string flags = " " + _cpuRequest("flags") + " ";
+		if (flags.find(" lm ") != std::string::npos) {
+			return "64";
+		} else {
+			return "32";
+		}
+	});
+}
+
+namespace {
+	/**
+	 * \brief Queries the capacity of a mount with \c statvfs().
+	 * \param mount The mount to query.
+	 */
+	void statMount(System::Mount& mount, const std::filesystem::path& root)
+		noexcept {
+		struct statvfs fs;
+		const std::string path = root == "/" ? mount.mountPoint :
+			(root / std::filesystem::path(mount.mountPoint).relative_path())
+			.string();
+		if (::statvfs(path.c_str(), &fs)) {
+			mount.status = System::Mount::Status::Failed;
+			mount.error = std::error_code(errno, std::system_category());
+			return;
+		}
+		mount.total = static_cast<std::uint64_t>(fs.f_blocks) * fs.f_frsize;
+		mount.free = static_cast<std::uint64_t>(fs.f_bfree) * fs.f_frsize;
+		mount.available = static_cast<std::uint64_t>(fs.f_bavail) * fs.f_frsize;
+		mount.inodesTotal = fs.f_files;
+		mount.inodesFree = fs.f_ffree;
+		mount.status = System::Mount::Status::OK;
+	}
+}
+
+std::vector<System::Mount> System::enumerateMounts(
+	const System::MountOptions& options,
+	const std::filesystem::path& mountinfo, const std::filesystem::path& root) {
+	std::vector<System::Mount> ret = System::parseMountInfo(
+		readFile(mountinfo));
+	if (!options.includePseudo) {
+		ret.erase(std::remove_if(ret.begin(), ret.end(),
+			[](const System::Mount& mount) {
+				return isPseudoFilesystem(mount.fsType);
+			}), ret.end());
+	}
+	queryMounts(ret, options, root, &statMount);
+	if (!options.includePseudo) {
+		// catch the pseudo filesystems we don't know by name
+		ret.erase(std::remove_if(ret.begin(), ret.end(),
+			[](const System::Mount& mount) {
+				return mount.status == System::Mount::Status::OK &&
+					mount.total == 0;
+			}), ret.end());
+	}
+	return ret;
+}
+
+namespace {
+	/**
+	 * \brief  Resolves a path as the kernel would if a directory were the root
+	 *         directory: absolute symlinks and \c .. can't lead out of it.
+	 * \param  root The directory to treat as the root directory.
+	 * \param  path The path to resolve, relative to \c root.
+	 * \return The resolved path, relative to \c root, e.g. \c "/var/lib".
+	 * \throws std::system_error if a component doesn't exist, or too many
+	 *         symlinks were followed.
+	 */
+	std::string resolveUnder(const std::filesystem::path& root,
+		const std::filesystem::path& path) {
+		// the components left to resolve, last first
+		std::vector<std::string> pending;
+		const auto push = [&](const std::filesystem::path& relative) {
+			const std::size_t end = pending.size();
+			for (const auto& part : relative.relative_path()) {
+				pending.push_back(part.string());
+			}
+			std::reverse(pending.begin() + end, pending.end());
+		};
+		push(path);
+		std::vector<std::string> resolved;
+		for (int links = 0; !pending.empty();) {
+			std::string part = std::move(pending.back());
+			pending.pop_back();
+			if (part.empty() || part == ".") continue;
+			if (part == "..") {
+				if (!resolved.empty()) resolved.pop_back();
+				continue;
+			}
+			std::filesystem::path real = root;
+			for (const auto& done : resolved) real /= done;
+			real /= part;
+			std::error_code err;
+			const auto status = std::filesystem::symlink_status(real, err);
+			if (err) {
+				throw std::system_error(err, "Failed to resolve " +
+					real.string());
+			}
+			if (!std::filesystem::is_symlink(status)) {
+				resolved.push_back(std::move(part));
+				continue;
+			}
+			// the same limit as Linux's MAXSYMLINKS
+			if (++links > 40) {
+				throw std::system_error(std::error_code(ELOOP,
+					std::system_category()), "Failed to resolve " +
+					(root / path.relative_path()).string());
+			}
+			const std::filesystem::path target =
+				std::filesystem::read_symlink(real);
+			if (target.is_absolute()) resolved.clear();
+			push(target);
+		}
+		std::string ret;
+		for (const auto& part : resolved) ret += "/" + part;
+		return ret.empty() ? "/" : ret;
+	}
+}
+
+System::Mount System::mountOf(const std::filesystem::path& path,
+	const System::MountOptions& options,
+	const std::filesystem::path& mountinfo, const std::filesystem::path& root) {
+	const std::string target = root == "/" ?
+		std::filesystem::canonical(path).string() : resolveUnder(root, path);
+	const std::vector<System::Mount> all = System::parseMountInfo(
+		readFile(mountinfo));
+	// later mounts shadow earlier ones at the same mount point
+	const System::Mount* best = nullptr;
+	for (const auto& mount : all) {
+		const std::string& point = mount.mountPoint;
+		if (target.compare(0, point.size(), point) != 0) continue;
+		if (target.size() != point.size() && point != "/" &&
+			target[point.size()] != '/') continue;
+		if (!best || point.size() >= best->mountPoint.size()) best = &mount;
+	}
+	if (!best) {
+		throw std::system_error(std::error_code(ENOENT, std::system_category()),
+			"Could not find the mount of " + target);
+	}
+	std::vector<System::Mount> ret = { *best };
+	queryMounts(ret, options, root, &statMount);
+	return ret.front();
+}
+
+std::shared_ptr<const System::Topology> System::Properties::CPUTopology() {
+	return _cached(_cpuTopology, [&]() {
+		return std::make_shared<const System::Topology>(
+			System::Topology::load(_roots.sys));
+	});
+}
+
+System::CPUUsage System::Properties::CPULoad() {
+	return _cached(_cpuLoad, [&]() {
+		if (!_cpuSampler) {
+			_cpuSampler = std::make_unique<System::CPUSampler>(_roots.proc,
+				_roots.sys);
+		}
+		return _cpuSampler->sample();
+	});
+}
+
+std::uint64_t System::Properties::RAMTotalBytes() {
+	return _cached(_ramTotal, [&]() -> std::uint64_t {
+		if (!_roots.live()) {
+			// sysinfo() describes the running kernel, so read the other tree
+			System::MemoryStats stats;
+			if (!System::MemoryStats::parse(readFile(_roots.proc / "meminfo"),
+				stats)) {
+				throw std::system_error(std::error_code(ENODATA,
+					std::system_category()), "Failed to parse meminfo");
+			}
+			return stats.total;
+		}
+		struct sysinfo sys;
+		if (sysinfo(&sys)) {
+			throw std::system_error(std::error_code(errno,
+				std::system_category()), "Failed to access sysinfo structure");
+		}
+		// totalram is measured in units of mem_unit bytes
+		return static_cast<std::uint64_t>(sys.totalram) * sys.mem_unit;
+	});
+}
+
+System::MemoryStats System::Properties::RAMStats() {
+	return _cached(_ramStats, [&]() {
+		if (!_memorySampler) {
+			_memorySampler = std::make_unique<System::MemorySampler>(
+				_roots.proc / "meminfo");
+		}
+		return _memorySampler->sample();
+	});
+}
+
+System::DiskUsage System::Properties::StorageLoad() {
+	return _cached(_storageLoad, [&]() {
+		if (!_diskSampler) {
+			_diskSampler = std::make_unique<System::DiskSampler>(_roots.proc);
+		}
+		return _diskSampler->sample();
+	});
+}
+
+std::vector<System::NetworkInterface> System::Properties::NetworkInterfaces() {
+	return _cached(_networkInterfaces, [&]() {
+		return System::enumerateNetworkInterfaces(_roots.sys, _roots.live());
+	});
+}
+
+System::NetworkUsage System::Properties::NetworkLoad() {
+	return _cached(_networkLoad, [&]() {
+		if (!_networkSampler) {
+			_networkSampler = std::make_unique<System::NetworkSampler>(
+				_roots.proc);
+		}
+		return _networkSampler->sample();
+	});
+}
+
+System::ProcessStats System::Properties::process(const std::int32_t pid) {
+	std::lock_guard<std::mutex> lock(_processMutex);
+	if (!_processSampler) {
+		_processSampler = std::make_unique<System::ProcessSampler>(_roots.proc);
+	}
+	System::ProcessStats stats;
+	if (!_processSampler->sample(pid, stats)) {
+		throw std::system_error(std::error_code(ESRCH,
+			std::system_category()), "Process " + std::to_string(pid) +
+			" does not exist");
+	}
+	return stats;
+}
+
+System::CgroupLimits System::Properties::ResourceLimits() {
+	return _cached(_resourceLimits, [&]() {
+		return System::CgroupLimits::load(_roots.proc, _roots.root);
+	});
+}
+
+std::uint32_t System::Properties::EffectiveCPUCount() {
+	double count = 0.0;
+	try {
+		count = static_cast<double>(CPUTopology()->cpus().size());
+	} catch (const std::system_error&) {
+		// sysfs has no topology, so fall back to cpuinfo
+	}
+	if (count == 0.0) {
+		try {
+			count = static_cast<double>(CPUSnapshot()->logicalCount());
+		} catch (const std::system_error&) {}
+	}
+	if (count == 0.0 && _roots.live()) {
+		count = static_cast<double>(std::thread::hardware_concurrency());
+	}
+	const System::CgroupLimits limits = _limitsOrNone();
+	if (!limits.cpus.empty()) {
+		count = std::min(count, static_cast<double>(limits.cpus.size()));
+	}
+	if (limits.cpuQuota > 0.0) count = std::min(count, limits.cpuQuota);
+	return std::max(static_cast<std::uint32_t>(std::ceil(count)), 1u);
+}
+
+std::uint64_t System::Properties::EffectiveRAMBytes() {
+	return std::min(RAMTotalBytes(), _limitsOrNone().memoryMax);
+}
+
+System::CgroupLimits System::Properties::_limitsOrNone() {
+	try {
+		return ResourceLimits();
+	} catch (const std::system_error&) {
+		// no cgroup v2 hierarchy, so nothing limits the process
+		return System::CgroupLimits();
+	}
+}
+
+System::MemorySampler::MemorySampler(const std::filesystem::path& path) :
+	_buffer(8192) {
+	_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (_fd < 0) {
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			"Failed to open " + path.string());
+	}
+}
+
+System::MemorySampler::~MemorySampler() noexcept {
+	if (_fd >= 0) ::close(_fd);
+}
+
+System::MemorySampler::MemorySampler(MemorySampler&& other) noexcept :
+	_fd(other._fd), _buffer(std::move(other._buffer)), _stats(other._stats) {
+	other._fd = -1;
+}
+
+System::MemorySampler& System::MemorySampler::operator=(
+	MemorySampler&& other) noexcept {
+	std::swap(_fd, other._fd);
+	_buffer.swap(other._buffer);
+	_stats = other._stats;
+	return *this;
+}
+
+const System::MemoryStats& System::MemorySampler::sample() {
+	std::size_t size = 0;
+	for (;;) {
+		const ssize_t got = ::pread(_fd, _buffer.data(), _buffer.size(), 0);
+		if (got < 0) {
+			if (errno == EINTR) continue;
+			throw std::system_error(std::error_code(errno,
+				std::system_category()), "Failed to read meminfo");
+		}
+		size = static_cast<std::size_t>(got);
+		// a full buffer means the file may have been truncated
+		if (size < _buffer.size()) break;
+		_buffer.resize(_buffer.size() * 2);
+	}
+	if (!System::MemoryStats::parse(std::string_view(_buffer.data(), size),
+		_stats)) {
+		throw std::system_error(std::error_code(ENODATA, std::system_category()),
+			"Failed to parse meminfo");
+	}
+	return _stats;
+}
+
+const System::MemoryStats& System::MemorySampler::last() const noexcept {
+	return _stats;
+}
+
+namespace {
+	/**
+	 * \brief The jiffy counters kept per CPU by \c System::CPUSampler.
+	 */
+	enum CPUField {
+		JiffiesUser,
+		JiffiesSystem,
+		JiffiesIOWait,
+		JiffiesSteal,
+		JiffiesIdle,
+		JiffiesTotal,
+		FIELDS
+	};
+
+	/**
+	 * \brief  Parses a \c cpu line of \c /proc/stat.
+	 * \param  line    The line, e.g. \c "cpu3 9234 0 1639 55817 146 0 0 70 0 0".
+	 * \param  id      Receives the CPU's ID, or \c -1 for the aggregate line.
+	 * \param  jiffies Receives the \c FIELDS counters of the line.
+	 * \return \c TRUE if the line was parsed, \c FALSE if it isn't a CPU line.
+	 */
+	bool parseCPUStatLine(std::string_view line, long long& id,
+		std::uint64_t* jiffies) noexcept {
+		if (line.size() < 4 || line.substr(0, 3) != "cpu") return false;
+		line.remove_prefix(3);
+		if (line[0] == ' ') {
+			id = -1;
+		} else {
+			std::uint64_t n = 0;
+			line = parseUnsigned(line, n);
+			if (line.empty()) return false;
+			id = static_cast<long long>(n);
+		}
+		// user nice system idle iowait irq softirq steal (guest is already
+		// counted within user and nice)
+		std::uint64_t v[8] = {};
+		for (auto& value : v) {
+			const std::string_view rest = parseUnsigned(line, value);
+			if (rest.data() == nullptr) break;
+			line = rest;
+		}
+		jiffies[JiffiesUser] = v[0] + v[1];
+		jiffies[JiffiesSystem] = v[2] + v[5] + v[6];
+		jiffies[JiffiesIdle] = v[3];
+		jiffies[JiffiesIOWait] = v[4];
+		jiffies[JiffiesSteal] = v[7];
+		jiffies[JiffiesTotal] = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] +
+			v[7];
+		return true;
+	}
+}
+
+System::CPUSampler::CPUSampler(const std::filesystem::path& procfs,
+	const std::filesystem::path& sysfs, const bool frequencies) {
+	const std::filesystem::path stat = procfs / "stat";
+	_statFd = ::open(stat.c_str(), O_RDONLY | O_CLOEXEC);
+	if (_statFd < 0) {
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			"Failed to open " + stat.string());
+	}
+	// the destructor won't run if this throws, so close what was opened
+	try {
+		// discover the online CPUs by reading the whole file once
+		_buffer.resize(4096);
+		std::string_view text = _read();
+		while (text.size() == _buffer.size()) {
+			_buffer.resize(_buffer.size() * 2);
+			text = _read();
+		}
+		std::size_t lines = 0;
+		forEachLine(text, [&](const std::string_view line) {
+			long long id = 0;
+			std::uint64_t jiffies[FIELDS];
+			if (!parseCPUStatLine(line, id, jiffies)) return;
+			++lines;
+			if (id >= 0) _usage.ids.push_back(static_cast<std::uint32_t>(id));
+		});
+		if (lines == 0) {
+			throw std::system_error(std::error_code(ENODATA,
+				std::system_category()), "Failed to parse " + stat.string());
+		}
+		// the CPU lines come first, so samples only need to read that far;
+		// leave enough room for every counter to grow to its maximum width
+		_buffer.resize(256 * (lines + 1));
+		_buffer.shrink_to_fit();
+
+		const std::size_t n = _usage.ids.size();
+		for (std::size_t i = 0; i < n; ++i) {
+			const std::size_t id = _usage.ids[i];
+			if (id >= _index.size()) _index.resize(id + 1, -1);
+			_index[id] = static_cast<int>(i);
+		}
+		_previous.assign((n + 1) * FIELDS, 0);
+		_current.assign((n + 1) * FIELDS, 0);
+		_usage.coreUtilization.assign(n, 0.0);
+		_usage.coreUser.assign(n, 0.0);
+		_usage.coreSystem.assign(n, 0.0);
+		_usage.coreIOWait.assign(n, 0.0);
+		_usage.coreSteal.assign(n, 0.0);
+		_usage.frequency.assign(n, 0);
+		_frequencyFds.assign(n, -1);
+		if (frequencies) {
+			for (std::size_t i = 0; i < n; ++i) {
+				const std::filesystem::path path = sysfs / "devices" /
+					"system" / "cpu" / ("cpu" + std::to_string(_usage.ids[i])) /
+					"cpufreq" / "scaling_cur_freq";
+				_frequencyFds[i] = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			}
+		}
+	} catch (...) {
+		::close(_statFd);
+		for (const int fd : _frequencyFds) if (fd >= 0) ::close(fd);
+		throw;
+	}
+}
+
+System::CPUSampler::~CPUSampler() noexcept {
+	if (_statFd >= 0) ::close(_statFd);
+	for (const int fd : _frequencyFds) if (fd >= 0) ::close(fd);
+}
+
+std::string_view System::CPUSampler::_read() {
+	for (;;) {
+		const ssize_t got = ::pread(_statFd, _buffer.data(), _buffer.size(), 0);
+		if (got >= 0) {
+			return std::string_view(_buffer.data(), static_cast<std::size_t>(got));
+		}
+		if (errno != EINTR) {
+			throw std::system_error(std::error_code(errno,
+				std::system_category()), "Failed to read /proc/stat");
+		}
+	}
+}
+
+const System::CPUUsage& System::CPUSampler::sample() {
+	// step 1: read the counters of every CPU line, which come first in the file
+	std::fill(_current.begin(), _current.end(), 0);
+	const std::string_view text = _read();
+	std::size_t pos = 0;
+	while (pos < text.size()) {
+		std::size_t end = findByte(text, '\n', pos);
+		if (end == std::string_view::npos) end = text.size();
+		long long id = 0;
+		std::uint64_t jiffies[FIELDS];
+		if (!parseCPUStatLine(text.substr(pos, end - pos), id, jiffies)) break;
+		pos = end + 1;
+		std::size_t row = 0;
+		if (id >= 0) {
+			if (static_cast<std::size_t>(id) >= _index.size() ||
+				_index[static_cast<std::size_t>(id)] < 0) continue;
+			row = static_cast<std::size_t>(_index[static_cast<std::size_t>(id)])
+				+ 1;
+		}
+		std::copy(jiffies, jiffies + FIELDS, _current.begin() + row * FIELDS);
+	}
+
+	// step 2: compute the deltas against the previous sample
+	const auto fraction = [&](const std::size_t row, const CPUField field,
+		const std::uint64_t total) -> double {
+		if (total == 0) return 0.0;
+		const std::uint64_t now = _current[row * FIELDS + field];
+		const std::uint64_t then = _previous[row * FIELDS + field];
+		return now > then ? static_cast<double>(now - then) / total : 0.0;
+	};
+	const auto delta = [&](const std::size_t row) -> std::uint64_t {
+		const std::uint64_t now = _current[row * FIELDS + JiffiesTotal];
+		const std::uint64_t then = _previous[row * FIELDS + JiffiesTotal];
+		return now > then ? now - then : 0;
+	};
+	const auto busy = [&](const std::size_t row, const std::uint64_t total) {
+		const double idle = fraction(row, JiffiesIdle, total) +
+			fraction(row, JiffiesIOWait, total);
+		return total == 0 || idle > 1.0 ? 0.0 : 1.0 - idle;
+	};
+	std::uint64_t total = delta(0);
+	_usage.utilization = busy(0, total);
+	_usage.user = fraction(0, JiffiesUser, total);
+	_usage.system = fraction(0, JiffiesSystem, total);
+	_usage.iowait = fraction(0, JiffiesIOWait, total);
+	_usage.steal = fraction(0, JiffiesSteal, total);
+	for (std::size_t i = 0; i < _usage.ids.size(); ++i) {
+		total = delta(i + 1);
+		_usage.coreUtilization[i] = busy(i + 1, total);
+		_usage.coreUser[i] = fraction(i + 1, JiffiesUser, total);
+		_usage.coreSystem[i] = fraction(i + 1, JiffiesSystem, total);
+		_usage.coreIOWait[i] = fraction(i + 1, JiffiesIOWait, total);
+		_usage.coreSteal[i] = fraction(i + 1, JiffiesSteal, total);
+	}
+	_previous.swap(_current);
+
+	// step 3: read the frequencies
+	for (std::size_t i = 0; i < _frequencyFds.size(); ++i) {
+		if (_frequencyFds[i] < 0) continue;
+		char value[32];
+		const ssize_t got = ::pread(_frequencyFds[i], value, sizeof(value), 0);
+		std::uint64_t frequency = 0;
+		if (got > 0) {
+			parseUnsigned(std::string_view(value, static_cast<std::size_t>(got)),
+				frequency);
+		}
+		_usage.frequency[i] = frequency;
+	}
+	return _usage;
+}
+
+const System::CPUUsage& System::CPUSampler::last() const noexcept {
+	return _usage;
+}
+
+namespace {
+	/**
+	 * \brief The counters kept per device by \c System::DiskSampler.
+	 */
+	enum DiskField {
+		DiskReads,
+		DiskSectorsRead,
+		DiskWrites,
+		DiskSectorsWritten,
+		DiskInFlight,
+		DiskTicks,
+		DiskQueueTicks,
+		DISK_FIELDS
+	};
+
+	/**
+	 * \brief   Parses a line of \c /proc/diskstats.
+	 * \details Every counter is cumulative since boot, except for
+	 *          \c DiskInFlight. The ticks are measured in milliseconds.
+	 * \param   line     The line, e.g.
+	 *                   \c "8 0 sda 4363 1287 261506 1604 1019 4052 ...".
+	 * \param   major    Receives the device's major number.
+	 * \param   minor    Receives the device's minor number.
+	 * \param   name     Receives the device's name, which views \c line.
+	 * \param   counters Receives the \c DISK_FIELDS counters of the line.
+	 * \return  \c TRUE if the line was parsed.
+	 */
+	bool parseDiskStatsLine(std::string_view line, std::uint64_t& major,
+		std::uint64_t& minor, std::string_view& name, std::uint64_t* counters)
+		noexcept {
+		line = parseUnsigned(line, major);
+		if (line.data() == nullptr) return false;
+		line = parseUnsigned(line, minor);
+		if (line.data() == nullptr) return false;
+		const auto first = line.find_first_not_of(" \t");
+		if (first == std::string_view::npos) return false;
+		line.remove_prefix(first);
+		name = line.substr(0, line.find_first_of(" \t"));
+		line.remove_prefix(name.size());
+		// reads merged sectors ms writes merged sectors ms in-flight ms
+		// weighted-ms, optionally followed by the discard and flush counters
+		std::uint64_t v[11];
+		for (auto& value : v) {
+			line = parseUnsigned(line, value);
+			if (line.data() == nullptr) return false;
+		}
+		counters[DiskReads] = v[0];
+		counters[DiskSectorsRead] = v[2];
+		counters[DiskWrites] = v[4];
+		counters[DiskSectorsWritten] = v[6];
+		counters[DiskInFlight] = v[8];
+		counters[DiskTicks] = v[9];
+		counters[DiskQueueTicks] = v[10];
+		return true;
+	}
+
+	/**
+	 * \brief  Reads the time since boot, including time spent suspended.
+	 * \return The time since boot, in seconds.
+	 */
+	double secondsSinceBoot() noexcept {
+		struct timespec now;
+		if (clock_gettime(CLOCK_BOOTTIME, &now)) return 0.0;
+		return static_cast<double>(now.tv_sec) +
+			static_cast<double>(now.tv_nsec) / 1e9;
+	}
+}
+
+System::DiskSampler::DiskSampler(const std::filesystem::path& procfs) {
+	const std::filesystem::path path = procfs / "diskstats";
+	_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (_fd < 0) {
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			"Failed to open " + path.string());
+	}
+	// the destructor won't run if this throws, so close what was opened
+	try {
+		// discover the devices by reading the whole file once
+		_buffer.resize(4096);
+		std::size_t size = 0;
+		for (;;) {
+			const ssize_t got = ::pread(_fd, _buffer.data(), _buffer.size(), 0);
+			if (got < 0 && errno == EINTR) continue;
+			if (got < 0) {
+				throw std::system_error(std::error_code(errno,
+					std::system_category()), "Failed to read " + path.string());
+			}
+			size = static_cast<std::size_t>(got);
+			if (size < _buffer.size()) break;
+			_buffer.resize(_buffer.size() * 2);
+		}
+		forEachLine(std::string_view(_buffer.data(), size),
+			[&](const std::string_view line) {
+			std::uint64_t major = 0, minor = 0;
+			std::string_view name;
+			std::uint64_t counters[DISK_FIELDS];
+			if (!parseDiskStatsLine(line, major, minor, name, counters)) return;
+			_usage.names.emplace_back(name);
+			_usage.major.push_back(static_cast<std::uint32_t>(major));
+			_usage.minor.push_back(static_cast<std::uint32_t>(minor));
+		});
+		// leave enough room for every counter of every line to grow to its
+		// maximum width, including the optional discard and flush counters
+		_buffer.resize(512 * (_usage.names.size() + 1));
+		_buffer.shrink_to_fit();
+
+		const std::size_t n = _usage.names.size();
+		_previous.assign(n * DISK_FIELDS, 0);
+		_current.assign(n * DISK_FIELDS, 0);
+		_usage.reads.assign(n, 0.0);
+		_usage.writes.assign(n, 0.0);
+		_usage.readBytes.assign(n, 0.0);
+		_usage.writeBytes.assign(n, 0.0);
+		_usage.queueDepth.assign(n, 0.0);
+		_usage.utilization.assign(n, 0.0);
+		_usage.inFlight.assign(n, 0);
+	} catch (...) {
+		::close(_fd);
+		throw;
+	}
+}
+
+System::DiskSampler::~DiskSampler() noexcept {
+	if (_fd >= 0) ::close(_fd);
+}
+
+void System::DiskSampler::_read() {
+	ssize_t got = 0;
+	for (;;) {
+		got = ::pread(_fd, _buffer.data(), _buffer.size(), 0);
+		if (got >= 0) break;
+		if (errno != EINTR) {
+			throw std::system_error(std::error_code(errno,
+				std::system_category()), "Failed to read /proc/diskstats");
+		}
+	}
+	std::string_view text(_buffer.data(), static_cast<std::size_t>(got));
+	// if devices were added, the buffer may have cut the last line short
+	if (text.size() == _buffer.size()) {
+		text = text.substr(0, text.rfind('\n') + 1);
+	}
+
+	std::fill(_current.begin(), _current.end(), 0);
+	const std::size_t n = _usage.names.size();
+	std::size_t row = 0;
+	forEachLine(text, [&](const std::string_view line) {
+		std::uint64_t major = 0, minor = 0;
+		std::string_view name;
+		std::uint64_t counters[DISK_FIELDS];
+		if (!parseDiskStatsLine(line, major, minor, name, counters)) return;
+		// the devices are usually listed in the same order every time, so
+		// only search for a device if it isn't where it was before
+		if (row >= n || _usage.major[row] != major ||
+			_usage.minor[row] != minor) {
+			const std::ptrdiff_t i = _usage.find(
+				static_cast<std::uint32_t>(major),
+				static_cast<std::uint32_t>(minor));
+			if (i < 0) return;
+			row = static_cast<std::size_t>(i);
+		}
+		std::copy(counters, counters + DISK_FIELDS,
+			_current.begin() + row * DISK_FIELDS);
+		++row;
+	});
+}
+
+const System::DiskUsage& System::DiskSampler::sample() {
+	_read();
+	const double now = secondsSinceBoot();
+	const double interval = now > _then ? now - _then : 0.0;
+	const auto delta = [&](const std::size_t row, const DiskField field) {
+		const std::uint64_t current = _current[row * DISK_FIELDS + field];
+		const std::uint64_t previous = _previous[row * DISK_FIELDS + field];
+		return current > previous ?
+			static_cast<double>(current - previous) : 0.0;
+	};
+	const auto rate = [&](const double value) {
+		return interval > 0.0 ? value / interval : 0.0;
+	};
+	_usage.interval = interval;
+	for (std::size_t i = 0; i < _usage.names.size(); ++i) {
+		// sectors are always 512 bytes in diskstats, whatever the device uses
+		_usage.reads[i] = rate(delta(i, DiskReads));
+		_usage.writes[i] = rate(delta(i, DiskWrites));
+		_usage.readBytes[i] = rate(delta(i, DiskSectorsRead) * 512.0);
+		_usage.writeBytes[i] = rate(delta(i, DiskSectorsWritten) * 512.0);
+		// the ticks are milliseconds
+		_usage.queueDepth[i] = rate(delta(i, DiskQueueTicks) / 1000.0);
+		_usage.utilization[i] = std::min(rate(delta(i, DiskTicks) / 1000.0),
+			1.0);
+		_usage.inFlight[i] = _current[i * DISK_FIELDS + DiskInFlight];
+	}
+	_previous.swap(_current);
+	_then = now;
+	return _usage;
+}
+
+const System::DiskUsage& System::DiskSampler::last() const noexcept {
+	return _usage;
+}
+
+System::DiskInventory System::enumerateDisks(
+	const std::filesystem::path& sysfs) {
+	System::DiskInventory ret;
+	std::vector<std::string> names;
+	std::error_code err;
+	std::filesystem::directory_iterator it(sysfs / "block", err);
+	if (err) return ret;
+	for (; it != std::filesystem::directory_iterator(); it.increment(err)) {
+		if (err) break;
+		// virtual devices, such as loop devices, aren't backed by hardware
+		std::error_code existsErr;
+		if (!std::filesystem::exists(it->path() / "device", existsErr)) {
+			continue;
+		}
+		names.push_back(it->path().filename().string());
+	}
+	std::sort(names.begin(), names.end());
+	for (const auto& name : names) {
+		const std::filesystem::path dev = sysfs / "block" / name;
+		std::uint64_t sectors = 0;
+		parseUnsigned(readAttribute(dev / "size"), sectors);
+		std::error_code linkErr;
+		const std::string bus = std::filesystem::canonical(dev / "device",
+			linkErr).string();
+		ret.ids.push_back(name);
+		ret.models.push_back(readAttribute(dev / "device" / "model"));
+		// the size is counted in 512 byte sectors, whatever the disk's own
+		// sector size is
+		ret.sizes.push_back(sectors * 512);
+		ret.removable.push_back(readAttribute(dev / "removable") == "1" ||
+			bus.find("/usb") != std::string::npos);
+	}
+	return ret;
+}
+
+namespace {
+	/**
+	 * \brief   Parses an SMBIOS memory device structure (type 17), and
+	 *          appends the module it describes to an inventory.
+	 * \details Empty slots, and structures too short to report a size, are
+	 *          skipped.
+	 * \param   raw The structure, followed by its strings.
+	 * \param   out The inventory to append to.
+	 */
+	void parseMemoryDevice(const std::string_view raw,
+		System::MemoryModuleInventory& out) {
+		if (raw.size() < 2 || static_cast<unsigned char>(raw[0]) != 17) return;
+		const std::size_t length = std::min<std::size_t>(
+			static_cast<unsigned char>(raw[1]), raw.size());
+		const auto byte = [&](const std::size_t offset) -> std::uint32_t {
+			return offset < length ? static_cast<unsigned char>(raw[offset]) :
+				0;
+		};
+		const auto word = [&](const std::size_t offset) {
+			return byte(offset) | byte(offset + 1) << 8;
+		};
+		const auto dword = [&](const std::size_t offset) {
+			return word(offset) | word(offset + 2) << 16;
+		};
+		if (length < 0x15) return;
+		const std::uint32_t size = word(0x0C);
+		if (size == 0) return;
+		std::uint64_t bytes = 0;
+		if (size == 0x7FFF) {
+			bytes = static_cast<std::uint64_t>(dword(0x1C) & 0x7FFFFFFF) << 20;
+		} else if (size != 0xFFFF) {
+			// bit 15 selects between KB and MB
+			bytes = static_cast<std::uint64_t>(size & 0x7FFF) <<
+				(size & 0x8000 ? 10 : 20);
+		}
+
+		// the strings follow the formatted area, each terminated by a NUL,
+		// and are referred to by their 1-based index
+		std::vector<std::string_view> strings;
+		std::string_view rest = raw.substr(length);
+		while (!rest.empty() && rest.front() != '\0') {
+			const std::size_t end = findByte(rest, '\0');
+			strings.push_back(trim(rest.substr(0, end)));
+			if (end == std::string_view::npos) break;
+			rest.remove_prefix(end + 1);
+		}
+		const auto string = [&](const std::size_t offset) {
+			const std::uint32_t index = byte(offset);
+			return index && index <= strings.size() ?
+				std::string(strings[index - 1]) : std::string();
+		};
+		std::uint32_t speed = word(0x15);
+		if (speed == 0xFFFF) speed = dword(0x54);
+
+		out.ids.push_back(string(0x10));
+		out.banks.push_back(string(0x11));
+		out.sizes.push_back(bytes);
+		out.speeds.push_back(speed);
+		out.types.push_back(memoryTypeName(byte(0x12)));
+		out.manufacturers.push_back(string(0x17));
+		out.partNumbers.push_back(string(0x1A));
+	}
+}
+
+System::MemoryModuleInventory System::enumerateMemoryModules(
+	const std::filesystem::path& sysfs) {
+	System::MemoryModuleInventory ret;
+	// the entries are named <type>-<instance>
+	std::vector<std::pair<std::uint64_t, std::filesystem::path>> devices;
+	std::error_code err;
+	std::filesystem::directory_iterator it(
+		sysfs / "firmware" / "dmi" / "entries", err);
+	if (err) return ret;
+	for (; it != std::filesystem::directory_iterator(); it.increment(err)) {
+		if (err) break;
+		const std::string name = it->path().filename().string();
+		if (name.compare(0, 3, "17-") != 0) continue;
+		std::uint64_t instance = 0;
+		parseUnsigned(std::string_view(name).substr(3), instance);
+		devices.emplace_back(instance, it->path());
+	}
+	std::sort(devices.begin(), devices.end());
+	for (const auto& device : devices) {
+		try {
+			parseMemoryDevice(readFile(device.second / "raw"), ret);
+		} catch (const std::system_error&) {
+			// only root can read the tables on most systems
+		}
+	}
+	return ret;
+}
+
+namespace {
+	/**
+	 * \brief The counters of \c /proc/net/dev kept by \c NetworkSampler.
+	 */
+	enum NetField {
+		NetRxBytes,
+		NetRxPackets,
+		NetRxErrors,
+		NetRxDrops,
+		NetTxBytes,
+		NetTxPackets,
+		NetTxErrors,
+		NetTxDrops,
+		NET_FIELDS
+	};
+
+	/**
+	 * \brief  Parses an interface's line of \c /proc/net/dev.
+	 * \param  line     The line, e.g. \c "  eth0: 1024 8 0 0 0 0 0 0 512 ...".
+	 * \param  name     Receives the interface's name.
+	 * \param  counters Receives the \c NET_FIELDS counters of the line.
+	 * \return \c TRUE if the line was parsed, \c FALSE if it is a header.
+	 */
+	bool parseNetDevLine(std::string_view line, std::string_view& name,
+		std::uint64_t* counters) noexcept {
+		const std::size_t colon = findByte(line, ':');
+		if (colon == std::string_view::npos) return false;
+		name = trim(line.substr(0, colon));
+		if (name.empty() || name.find('|') != std::string_view::npos) {
+			return false;
+		}
+		// receive: bytes packets errs drop fifo frame compressed multicast
+		// transmit: bytes packets errs drop fifo colls carrier compressed
+		std::uint64_t v[16] = {};
+		line.remove_prefix(colon + 1);
+		for (auto& value : v) {
+			line = parseUnsigned(line, value);
+			if (line.data() == nullptr) return false;
+		}
+		counters[NetRxBytes] = v[0];
+		counters[NetRxPackets] = v[1];
+		counters[NetRxErrors] = v[2];
+		counters[NetRxDrops] = v[3];
+		counters[NetTxBytes] = v[8];
+		counters[NetTxPackets] = v[9];
+		counters[NetTxErrors] = v[10];
+		counters[NetTxDrops] = v[11];
+		return true;
+	}
+}
+
+std::vector<System::NetworkInterface> System::enumerateNetworkInterfaces(
+	const std::filesystem::path& sysfs, const bool addresses) {
+	std::vector<System::NetworkInterface> ret;
+	std::error_code ec;
+	for (const auto& entry : std::filesystem::directory_iterator(
+		sysfs / "class" / "net", ec)) {
+		const std::filesystem::path& dir = entry.path();
+		System::NetworkInterface iface;
+		iface.name = dir.filename().string();
+		iface.mac = readAttribute(dir / "address");
+		// point-to-point and tunnel interfaces report a zero address
+		if (iface.mac.find_first_not_of("0:") == std::string::npos) {
+			iface.mac.clear();
+		}
+		std::uint64_t value = 0;
+		if (parseUnsigned(readAttribute(dir / "mtu"), value).data()) {
+			iface.mtu = static_cast<std::uint32_t>(value);
+		}
+		// reading the speed fails with EINVAL if the link is down, and
+		// virtual interfaces report -1
+		if (parseUnsigned(readAttribute(dir / "speed"), value).data()) {
+			iface.speed = value;
+		}
+		// e.g. "0x1003": IFF_UP is 0x1, IFF_LOOPBACK is 0x8
+		const std::uint32_t flags = readHexAttribute(dir / "flags");
+		iface.up = (flags & 0x1) != 0;
+		iface.loopback = (flags & 0x8) != 0;
+		const std::string node = readAttribute(dir / "device" / "numa_node");
+		if (!node.empty() && node[0] != '-' &&
+			parseUnsigned(node, value).data()) {
+			iface.node = static_cast<std::int32_t>(value);
+		}
+		ret.push_back(std::move(iface));
+	}
+	std::sort(ret.begin(), ret.end(), [](const System::NetworkInterface& a,
+		const System::NetworkInterface& b) { return a.name < b.name; });
+	if (!addresses) return ret;
+
+	struct ifaddrs* list = nullptr;
+	if (::getifaddrs(&list)) {
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			"Failed to look up the network addresses");
+	}
+	for (const struct ifaddrs* a = list; a; a = a->ifa_next) {
+		if (!a->ifa_addr || !a->ifa_name) continue;
+		const int family = a->ifa_addr->sa_family;
+		if (family != AF_INET && family != AF_INET6) continue;
+		const auto iface = std::find_if(ret.begin(), ret.end(),
+			[&](const System::NetworkInterface& i) {
+			return i.name == a->ifa_name;
+		});
+		if (iface == ret.end()) continue;
+		char text[INET6_ADDRSTRLEN] = {};
+		const void* address = nullptr;
+		if (family == AF_INET) {
+			address = &reinterpret_cast<const struct sockaddr_in*>(
+				a->ifa_addr)->sin_addr;
+		} else {
+			address = &reinterpret_cast<const struct sockaddr_in6*>(
+				a->ifa_addr)->sin6_addr;
+		}
+		if (!::inet_ntop(family, address, text, sizeof(text))) continue;
+		(family == AF_INET ? iface->ipv4 : iface->ipv6).emplace_back(text);
+	}
+	::freeifaddrs(list);
+	return ret;
+}
+
+System::NetworkSampler::NetworkSampler(const std::filesystem::path& procfs) {
+	const std::filesystem::path path = procfs / "net" / "dev";
+	_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (_fd < 0) {
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			"Failed to open " + path.string());
+	}
+	// the destructor won't run if this throws, so close what was opened
+	try {
+		// discover the interfaces by reading the whole file once
+		_buffer.resize(4096);
+		std::size_t size = 0;
+		for (;;) {
+			const ssize_t got = ::pread(_fd, _buffer.data(), _buffer.size(), 0);
+			if (got < 0 && errno == EINTR) continue;
+			if (got < 0) {
+				throw std::system_error(std::error_code(errno,
+					std::system_category()), "Failed to read " + path.string());
+			}
+			size = static_cast<std::size_t>(got);
+			if (size < _buffer.size()) break;
+			_buffer.resize(_buffer.size() * 2);
+		}
+		forEachLine(std::string_view(_buffer.data(), size),
+			[&](const std::string_view line) {
+			std::string_view name;
+			std::uint64_t counters[NET_FIELDS];
+			if (!parseNetDevLine(line, name, counters)) return;
+			_usage.names.emplace_back(name);
+		});
+		// leave enough room for every counter of every line to grow to its
+		// maximum width, plus the two header lines
+		_buffer.resize(384 * (_usage.names.size() + 2));
+		_buffer.shrink_to_fit();
+
+		const std::size_t n = _usage.names.size();
+		_previous.assign(n * NET_FIELDS, 0);
+		_current.assign(n * NET_FIELDS, 0);
+		_usage.rxBytes.assign(n, 0.0);
+		_usage.txBytes.assign(n, 0.0);
+		_usage.rxPackets.assign(n, 0.0);
+		_usage.txPackets.assign(n, 0.0);
+		_usage.rxErrors.assign(n, 0.0);
+		_usage.txErrors.assign(n, 0.0);
+		_usage.rxDrops.assign(n, 0.0);
+		_usage.txDrops.assign(n, 0.0);
+	} catch (...) {
+		::close(_fd);
+		throw;
+	}
+}
+
+System::NetworkSampler::~NetworkSampler() noexcept {
+	if (_fd >= 0) ::close(_fd);
+}
+
+void System::NetworkSampler::_read() {
+	ssize_t got = 0;
+	for (;;) {
+		got = ::pread(_fd, _buffer.data(), _buffer.size(), 0);
+		if (got >= 0) break;
+		if (errno != EINTR) {
+			throw std::system_error(std::error_code(errno,
+				std::system_category()), "Failed to read /proc/net/dev");
+		}
+	}
+	std::string_view text(_buffer.data(), static_cast<std::size_t>(got));
+	// if interfaces were added, the buffer may have cut the last line short
+	if (text.size() == _buffer.size()) {
+		text = text.substr(0, text.rfind('\n') + 1);
+	}
+
+	std::fill(_current.begin(), _current.end(), 0);
+	const std::size_t n = _usage.names.size();
+	std::size_t row = 0;
+	forEachLine(text, [&](const std::string_view line) {
+		std::string_view name;
+		std::uint64_t counters[NET_FIELDS];
+		if (!parseNetDevLine(line, name, counters)) return;
+		// the interfaces are usually listed in the same order every time, so
+		// only search for an interface if it isn't where it was before
+		if (row >= n || _usage.names[row] != name) {
+			const std::ptrdiff_t i = _usage.find(name);
+			if (i < 0) return;
+			row = static_cast<std::size_t>(i);
+		}
+		std::copy(counters, counters + NET_FIELDS,
+			_current.begin() + row * NET_FIELDS);
+		++row;
+	});
+}
+
+const System::NetworkUsage& System::NetworkSampler::sample() {
+	_read();
+	const double now = secondsSinceBoot();
+	const double interval = now > _then ? now - _then : 0.0;
+	const auto rate = [&](const std::size_t row, const NetField field) {
+		const std::uint64_t current = _current[row * NET_FIELDS + field];
+		const std::uint64_t previous = _previous[row * NET_FIELDS + field];
+		// counters restart from zero if an interface is recreated
+		if (interval <= 0.0 || current <= previous) return 0.0;
+		return static_cast<double>(current - previous) / interval;
+	};
+	_usage.interval = interval;
+	for (std::size_t i = 0; i < _usage.names.size(); ++i) {
+		_usage.rxBytes[i] = rate(i, NetRxBytes);
+		_usage.txBytes[i] = rate(i, NetTxBytes);
+		_usage.rxPackets[i] = rate(i, NetRxPackets);
+		_usage.txPackets[i] = rate(i, NetTxPackets);
+		_usage.rxErrors[i] = rate(i, NetRxErrors);
+		_usage.txErrors[i] = rate(i, NetTxErrors);
+		_usage.rxDrops[i] = rate(i, NetRxDrops);
+		_usage.txDrops[i] = rate(i, NetTxDrops);
+	}
+	_previous.swap(_current);
+	_then = now;
+	return _usage;
+}
+
+const System::NetworkUsage& System::NetworkSampler::last() const noexcept {
+	return _usage;
+}
+
+namespace {
+	/**
+	 * \brief  Lists the entries of an open directory, without allocating.
+	 * \param  fd      The directory's descriptor. It is read from its start.
+	 * \param  entries The buffer to list the entries into.
+	 * \param  fn      The function to call. It is given the name of each
+	 *                 entry, except for \c "." and \c "..".
+	 * \return \c TRUE if the directory was listed, \c FALSE if it could not
+	 *         be, in which case \c errno says why.
+	 */
+	template<typename Fn>
+	bool forEachEntry(const int fd, std::vector<char>& entries, Fn&& fn) {
+		if (::lseek(fd, 0, SEEK_SET) < 0) return false;
+		// the layout of linux_dirent64: d_ino, d_off, d_reclen, d_type, d_name
+		constexpr std::size_t RECLEN = 16, NAME = 19;
+		for (;;) {
+			const long got = ::syscall(SYS_getdents64, fd, entries.data(),
+				entries.size());
+			if (got < 0) return false;
+			if (got == 0) return true;
+			for (long pos = 0; pos < got;) {
+				const char* entry = entries.data() + pos;
+				unsigned short length = 0;
+				std::memcpy(&length, entry + RECLEN, sizeof(length));
+				const std::string_view name(entry + NAME);
+				if (name != "." && name != "..") fn(name);
+				pos += length;
+			}
+		}
+	}
+
+	/**
+	 * \brief  Finds the value of a \c "Key: value" line in a procfs file.
+	 * \param  text The contents of the file.
+	 * \param  key  The key, including its colon, e.g. \c "VmHWM:".
+	 * \param  value Receives the value's leading integer.
+	 * \return \c TRUE if the key was found.
+	 */
+	bool findField(const std::string_view text, const std::string_view key,
+		std::uint64_t& value) noexcept {
+		std::size_t pos = 0;
+		while ((pos = text.find(key, pos)) != std::string_view::npos) {
+			if (pos == 0 || text[pos - 1] == '\n') {
+				return parseUnsigned(text.substr(pos + key.size()), value)
+					.data() != nullptr;
+			}
+			pos += key.size();
+		}
+		return false;
+	}
+}
+
+System::ProcessSampler::ProcessSampler(const std::filesystem::path& procfs,
+	const bool rollup) : _rollup(rollup), _buffer(16384), _entries(32768) {
+	_procFd = ::open(procfs.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (_procFd < 0) {
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			"Failed to open " + procfs.string());
+	}
+	const long ticks = ::sysconf(_SC_CLK_TCK);
+	if (ticks > 0) _tick = 1000000000ULL / static_cast<std::uint64_t>(ticks);
+	const long page = ::sysconf(_SC_PAGESIZE);
+	if (page > 0) _pageSize = static_cast<std::uint64_t>(page);
+}
+
+System::ProcessSampler::~ProcessSampler() noexcept {
+	if (_procFd >= 0) ::close(_procFd);
+}
+
+bool System::ProcessSampler::sample(const std::int32_t pid,
+	System::ProcessStats& out) {
+	char name[16];
+	if (pid > 0) {
+		std::snprintf(name, sizeof(name), "%d", static_cast<int>(pid));
+	} else {
+		std::snprintf(name, sizeof(name), "self");
+	}
+	const int dir = ::openat(_procFd, name,
+		O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (dir < 0) {
+		if (errno == ENOENT || errno == ESRCH) return false;
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			std::string("Failed to open process directory ") + name);
+	}
+	const bool sampled = _sample(dir, out);
+	const int error = errno;
+	::close(dir);
+	if (!sampled && error != ENOENT && error != ESRCH) {
+		throw std::system_error(std::error_code(error, std::system_category()),
+			std::string("Failed to read the stat file of process ") + name);
+	}
+	return sampled;
+}
+
+std::size_t System::ProcessSampler::scan(
+	std::vector<System::ProcessStats>& out) {
+	out.clear();
+	// _sample() reuses _buffer, but not _entries, so listing can continue
+	const bool listed = forEachEntry(_procFd, _entries,
+		[&](const std::string_view name) {
+		std::uint64_t pid = 0;
+		const std::string_view rest = parseUnsigned(name, pid);
+		if (rest.data() == nullptr || !rest.empty()) return;
+		const int dir = ::openat(_procFd, name.data(),
+			O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (dir < 0) return;
+		out.emplace_back();
+		if (!_sample(dir, out.back())) out.pop_back();
+		::close(dir);
+	});
+	if (!listed) {
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			"Failed to list the processes");
+	}
+	std::sort(out.begin(), out.end(), [](const System::ProcessStats& a,
+		const System::ProcessStats& b) { return a.pid < b.pid; });
+	return out.size();
+}
+
+std::string_view System::ProcessSampler::_read(const int dir,
+	const char* name) noexcept {
+	const int fd = ::openat(dir, name, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return std::string_view();
+	std::size_t size = 0;
+	for (;;) {
+		const ssize_t got = ::read(fd, _buffer.data() + size,
+			_buffer.size() - size);
+		if (got < 0 && errno == EINTR) continue;
+		if (got < 0) {
+			const int error = errno;
+			::close(fd);
+			errno = error;
+			return std::string_view();
+		}
+		size += static_cast<std::size_t>(got);
+		// every field this reads is near the start, so a full buffer is fine
+		if (got == 0 || size == _buffer.size()) break;
+	}
+	::close(fd);
+	return std::string_view(_buffer.data(), size);
+}
+
+long System::ProcessSampler::_countFDs(const int dir) noexcept {
+	const int fd = ::openat(dir, "fd",
+		O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0) return -1;
+	long count = 0;
+	const bool listed = forEachEntry(fd, _buffer,
+		[&](const std::string_view) { ++count; });
+	::close(fd);
+	return listed ? count : -1;
+}
+
+bool System::ProcessSampler::_sample(const int dir,
+	System::ProcessStats& out) {
+	out = System::ProcessStats();
+
+	// pid (comm) state ppid ... the name can contain spaces and parentheses,
+	// so the fields are found after its last ')'
+	std::string_view text = _read(dir, "stat");
+	if (text.data() == nullptr) return false;
+	const std::size_t open = text.find('('), close = text.rfind(')');
+	if (open == std::string_view::npos || close == std::string_view::npos ||
+		close < open || close + 2 >= text.size()) {
+		errno = EINVAL;
+		return false;
+	}
+	std::uint64_t pid = 0;
+	parseUnsigned(text, pid);
+	out.pid = static_cast<std::int32_t>(pid);
+	const std::string_view comm = text.substr(open + 1, close - open - 1);
+	std::memcpy(out.name, comm.data(),
+		std::min(comm.size(), sizeof(out.name) - 1));
+	out.state = text[close + 2];
+	// the fields after the state, starting with field 4 (ppid), up to and
+	// including field 24 (rss)
+	std::uint64_t fields[21] = {};
+	std::string_view rest = text.substr(close + 3);
+	for (auto& field : fields) {
+		// some fields, e.g. tty_nr, can be negative: count them as 0
+		const auto first = rest.find_first_not_of(' ');
+		if (first == std::string_view::npos) break;
+		rest.remove_prefix(first);
+		if (rest[0] == '-') {
+			const auto space = rest.find(' ');
+			rest.remove_prefix(space == std::string_view::npos ? rest.size() :
+				space);
+			continue;
+		}
+		const std::string_view after = parseUnsigned(rest, field);
+		if (after.data() == nullptr) break;
+		rest = after;
+	}
+	const auto field = [&](const int n) { return fields[n - 4]; };
+	out.parent = static_cast<std::int32_t>(field(4));
+	out.minorFaults = field(10);
+	out.majorFaults = field(12);
+	out.userTime = field(14) * _tick;
+	out.systemTime = field(15) * _tick;
+	out.threads = static_cast<std::uint32_t>(field(20));
+	out.startTime = field(22) * _tick;
+	out.virtualSize = field(23);
+	out.rss = field(24) * _pageSize;
+
+	// size resident shared text lib data dt, in pages
+	text = _read(dir, "statm");
+	if (text.data() != nullptr) {
+		std::uint64_t pages[3] = {};
+		for (auto& value : pages) {
+			text = parseUnsigned(text, value);
+			if (text.data() == nullptr) break;
+		}
+		out.shared = pages[2] * _pageSize;
+	} else {
+		out.complete = false;
+	}
+
+	text = _read(dir, "status");
+	if (text.data() != nullptr) {
+		std::uint64_t kb = 0;
+		if (findField(text, "VmHWM:", kb)) out.peakRSS = kb * 1024;
+		if (findField(text, "VmSwap:", kb)) out.swap = kb * 1024;
+		findField(text, "voluntary_ctxt_switches:", out.voluntarySwitches);
+		findField(text, "nonvoluntary_ctxt_switches:",
+			out.involuntarySwitches);
+	} else {
+		out.complete = false;
+	}
+
+	if (_rollup) {
+		text = _read(dir, "smaps_rollup");
+		std::uint64_t kb = 0;
+		if (text.data() != nullptr && findField(text, "Pss:", kb)) {
+			out.pss = kb * 1024;
+		} else {
+			out.complete = false;
+		}
+	}
+
+	const long fds = _countFDs(dir);
+	if (fds >= 0) {
+		out.fds = static_cast<std::uint32_t>(fds);
+	} else {
+		out.complete = false;
+	}
+	return true;
+}
+
+namespace {
+	/**
+	 * \brief  Parses a cgroup limit, which is either an integer or \c "max".
+	 * \param  text  The limit to parse.
+	 * \param  limit Receives the limit, or \c UINT64_MAX if it is \c "max".
+	 * \return \c TRUE if the limit was parsed.
+	 */
+	bool parseLimit(const std::string_view text, std::uint64_t& limit)
+		noexcept {
+		if (text.substr(0, 3) == "max") {
+			limit = UINT64_MAX;
+			return true;
+		}
+		return parseUnsigned(text, limit).data() != nullptr;
+	}
+
+	/**
+	 * \brief  Reads a cgroup interface file, which may not exist.
+	 * \param  path The path of the file.
+	 * \return The contents of the file, or an empty string if it could not be
+	 *         read.
+	 */
+	std::string readCgroupFile(const std::filesystem::path& path) {
+		std::error_code ec;
+		if (!std::filesystem::is_regular_file(path, ec)) return std::string();
+		try {
+			return readFile(path);
+		} catch (const std::system_error&) {
+			return std::string();
+		}
+	}
+}
+
+System::CgroupLimits System::CgroupLimits::load(
+	const std::filesystem::path& procfs, const std::filesystem::path& root) {
+	System::CgroupLimits ret;
+	// the unified hierarchy is listed as "0::/path"
+	std::string group;
+	forEachLine(readCgroupFile(procfs / "self" / "cgroup"),
+		[&](const std::string_view line) {
+		if (line.substr(0, 3) == "0::") group = std::string(line.substr(3));
+	});
+	const std::vector<System::Mount> mounts = System::parseMountInfo(
+		readFile(procfs / "self" / "mountinfo"));
+	const auto mount = std::find_if(mounts.begin(), mounts.end(),
+		[](const System::Mount& m) { return m.fsType == "cgroup2"; });
+	if (mount == mounts.end() || group.empty()) return ret;
+	ret.path = group;
+
+	// if the hierarchy is mounted from a subdirectory (e.g. in a container
+	// without a cgroup namespace), the group is relative to that; a group
+	// outside of it (e.g. "/../..") can only be read from the mount's root
+	std::string_view relative = group;
+	const std::string_view mountRoot = mount->root == "/" ? std::string_view() :
+		std::string_view(mount->root);
+	if (relative.substr(0, mountRoot.size()) == mountRoot &&
+		(relative.size() == mountRoot.size() ||
+		relative[mountRoot.size()] == '/')) {
+		relative.remove_prefix(mountRoot.size());
+	} else {
+		relative = std::string_view();
+	}
+	const std::filesystem::path base = (root / std::filesystem::path(
+		mount->mountPoint).relative_path()).lexically_normal();
+	std::filesystem::path leaf = base;
+	if (!relative.empty()) {
+		leaf = (base / std::filesystem::path(std::string(relative))
+			.relative_path()).lexically_normal();
+	}
+	ret.directory = leaf;
+
+	// these already account for every ancestor
+	const std::string cpus = readCgroupFile(leaf / "cpuset.cpus.effective");
+	if (!trim(cpus).empty()) ret.cpus = parseCPUList(cpus);
+	parseUnsigned(readCgroupFile(leaf / "memory.current"), ret.memoryCurrent);
+	System::PressureStats pressure;
+	System::PressureStats::parse(readCgroupFile(leaf / "memory.pressure"),
+		pressure);
+	ret.memoryPressure = pressure.some.avg10;
+
+	// but these only apply to the group they're set on, so the tightest limit
+	// of the leaf and its ancestors is found
+	std::filesystem::path dir = leaf;
+	for (;;) {
+		// $MAX $PERIOD
+		const std::string cpu = readCgroupFile(dir / "cpu.max");
+		std::uint64_t quota = 0, period = 0;
+		if (parseLimit(cpu, quota) && quota != UINT64_MAX) {
+			const std::size_t space = cpu.find(' ');
+			if (space != std::string::npos &&
+				parseUnsigned(std::string_view(cpu).substr(space), period)
+				.data() != nullptr && period > 0) {
+				const double cpus = static_cast<double>(quota) /
+					static_cast<double>(period);
+				if (ret.cpuQuota == 0.0 || cpus < ret.cpuQuota) {
+					ret.cpuQuota = cpus;
+				}
+			}
+		}
+		std::uint64_t memory = 0;
+		if (parseLimit(readCgroupFile(dir / "memory.max"), memory)) {
+			ret.memoryMax = std::min(ret.memoryMax, memory);
+		}
+		// 8:16 rbps=2097152 wbps=max riops=max wiops=120
+		forEachLine(readCgroupFile(dir / "io.max"),
+			[&](std::string_view line) {
+			std::uint64_t major = 0, minor = 0;
+			line = parseUnsigned(line, major);
+			if (line.empty() || line[0] != ':') return;
+			line = parseUnsigned(line.substr(1), minor);
+			if (line.data() == nullptr) return;
+			auto limit = std::find_if(ret.io.begin(), ret.io.end(),
+				[&](const System::IOLimit& l) {
+				return l.major == major && l.minor == minor;
+			});
+			if (limit == ret.io.end()) {
+				System::IOLimit added;
+				added.major = static_cast<std::uint32_t>(major);
+				added.minor = static_cast<std::uint32_t>(minor);
+				limit = ret.io.insert(ret.io.end(), added);
+			}
+			const std::pair<std::string_view, std::uint64_t System::IOLimit::*>
+				keys[] = { { "rbps=", &System::IOLimit::readBytes },
+				{ "wbps=", &System::IOLimit::writeBytes },
+				{ "riops=", &System::IOLimit::reads },
+				{ "wiops=", &System::IOLimit::writes } };
+			for (const auto& key : keys) {
+				const std::size_t pos = line.find(key.first);
+				std::uint64_t value = 0;
+				if (pos != std::string_view::npos && parseLimit(
+					line.substr(pos + key.first.size()), value)) {
+					(*limit).*key.second = std::min((*limit).*key.second,
+						value);
+				}
+			}
+		});
+		if (dir == base || !dir.has_relative_path()) break;
+		dir = dir.parent_path();
+	}
+	return ret;
+}
+
+bool System::PressureStats::parse(const std::string_view text,
+	System::PressureStats& stats) noexcept {
+	stats = System::PressureStats();
+	bool some = false;
+	forEachLine(text, [&](const std::string_view line) {
+		// some avg10=0.31 avg60=0.12 avg300=0.04 total=1184632
+		System::PressureStall* stall = nullptr;
+		if (line.substr(0, 5) == "some ") {
+			stall = &stats.some;
+			some = true;
+		} else if (line.substr(0, 5) == "full ") {
+			stall = &stats.full;
+		} else {
+			return;
+		}
+		const std::pair<std::string_view, double*> averages[] = {
+			{ "avg10=", &stall->avg10 }, { "avg60=", &stall->avg60 },
+			{ "avg300=", &stall->avg300 } };
+		for (const auto& average : averages) {
+			const std::size_t pos = line.find(average.first);
+			if (pos == std::string_view::npos) continue;
+			const std::string_view value = line.substr(pos +
+				average.first.size());
+			std::from_chars(value.data(), value.data() + value.size(),
+				*average.second);
+		}
+		const std::size_t total = line.find("total=");
+		if (total != std::string_view::npos) {
+			parseUnsigned(line.substr(total + 6), stall->total);
+		}
+	});
+	return some;
+}
+
+const System::PressureStats& System::PressureSnapshot::operator[](
+	const System::PressureResource resource) const noexcept {
+	switch (resource) {
+	case System::PressureResource::CPU: return cpu;
+	case System::PressureResource::Memory: return memory;
+	default: return io;
+	}
+}
+
+namespace {
+	/**
+	 * \brief  Retrieves the name of a resource's PSI file.
+	 * \param  resource The resource.
+	 * \return The name, e.g. \c "memory".
+	 */
+	const char* pressureName(const System::PressureResource resource)
+		noexcept {
+		switch (resource) {
+		case System::PressureResource::CPU: return "cpu";
+		case System::PressureResource::Memory: return "memory";
+		default: return "io";
+		}
+	}
+
+	/**
+	 * \brief  Reads the PSI files of every resource.
+	 * \param  dir    The directory of the files.
+	 * \param  suffix Appended to each resource's name to form its file's
+	 *                name, e.g. \c ".pressure" for cgroups.
+	 * \return The pressure on each resource.
+	 * \throws std::system_error if a file could not be read or parsed.
+	 */
+	System::PressureSnapshot readPressure(const std::filesystem::path& dir,
+		const std::string& suffix) {
+		System::PressureSnapshot ret;
+		const std::pair<System::PressureResource, System::PressureStats*>
+			files[] = { { System::PressureResource::CPU, &ret.cpu },
+			{ System::PressureResource::Memory, &ret.memory },
+			{ System::PressureResource::IO, &ret.io } };
+		for (const auto& file : files) {
+			const std::filesystem::path path = dir /
+				(pressureName(file.first) + suffix);
+			if (!System::PressureStats::parse(readFile(path), *file.second)) {
+				throw std::system_error(std::error_code(EINVAL,
+					std::system_category()), "Failed to parse " +
+					path.string());
+			}
+		}
+		return ret;
+	}
+}
+
+System::PressureSnapshot System::Properties::Pressure() {
+	return _cached(_pressure, [&]() {
+		return readPressure(_roots.proc / "pressure", "");
+	});
+}
+
+System::PressureSnapshot System::Properties::CgroupPressure() {
+	return _cached(_cgroupPressure, [&]() {
+		const std::filesystem::path dir = ResourceLimits().directory;
+		if (dir.empty()) {
+			throw std::system_error(std::error_code(ENOENT,
+				std::system_category()), "The process isn't in a cgroup v2 "
+				"hierarchy");
+		}
+		return readPressure(dir, ".pressure");
+	});
+}
+
+System::PressureMonitor::PressureMonitor(const std::filesystem::path& procfs)
+	: _procfs(procfs) {
+	const int fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (fd < 0) {
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			"Failed to create the PSI monitor's wake-up event");
+	}
+	_fds.push_back({ fd, POLLIN, 0 });
+}
+
+System::PressureMonitor::~PressureMonitor() noexcept {
+	for (const auto& fd : _fds) ::close(fd.fd);
+}
+
+std::size_t System::PressureMonitor::watch(
+	const System::PressureResource resource, const bool full,
+	const std::chrono::microseconds stall,
+	const std::chrono::microseconds window) {
+	return watch(_procfs / "pressure" / pressureName(resource), full, stall,
+		window);
+}
+
+std::size_t System::PressureMonitor::watch(const std::filesystem::path& file,
+	const bool full, const std::chrono::microseconds stall,
+	const std::chrono::microseconds window) {
+	if (stall.count() <= 0 || stall > window) {
+		throw std::system_error(std::error_code(EINVAL,
+			std::system_category()), "The stall time of a PSI trigger must be "
+			"positive and no longer than its window");
+	}
+	const int fd = ::open(file.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0) {
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			"Failed to open " + file.string());
+	}
+	// e.g. "some 150000 1000000", including the terminating null
+	char trigger[64];
+	const int length = std::snprintf(trigger, sizeof(trigger), "%s %lld %lld",
+		full ? "full" : "some", static_cast<long long>(stall.count()),
+		static_cast<long long>(window.count()));
+	if (::write(fd, trigger, static_cast<std::size_t>(length) + 1) < 0) {
+		const int error = errno;
+		::close(fd);
+		throw std::system_error(std::error_code(error, std::system_category()),
+			"Failed to set a trigger on " + file.string());
+	}
+	_fds.push_back({ fd, POLLPRI, 0 });
+	return _fds.size() - 2;
+}
+
+bool System::PressureMonitor::wait(const std::chrono::milliseconds timeout,
+	std::vector<std::size_t>& fired) {
+	fired.clear();
+	int ready = 0;
+	do {
+		ready = ::poll(_fds.data(), _fds.size(),
+			timeout.count() < 0 ? -1 : static_cast<int>(timeout.count()));
+	} while (ready < 0 && errno == EINTR);
+	if (ready < 0) {
+		throw std::system_error(std::error_code(errno, std::system_category()),
+			"Failed to wait for PSI triggers");
+	}
+	if (_fds[0].revents & POLLIN) {
+		std::uint64_t count = 0;
+		[[maybe_unused]] const ssize_t got = ::read(_fds[0].fd, &count,
+			sizeof(count));
+	}
+	for (std::size_t i = 1; i < _fds.size(); ++i) {
+		if (_fds[i].revents & POLLERR) {
+			throw std::system_error(std::error_code(ENODEV,
+				std::system_category()), "PSI trigger " +
+				std::to_string(i - 1) + " was destroyed");
+		}
+		if (_fds[i].revents & POLLPRI) fired.push_back(i - 1);
+	}
+	return !fired.empty();
+}
+
+void System::PressureMonitor::wake() noexcept {
+	const std::uint64_t one = 1;
+	[[maybe_unused]] const ssize_t wrote = ::write(_fds[0].fd, &one,
+		sizeof(one));
+}
+
+std::size_t System::PressureMonitor::size() const noexcept {
+	return _fds.size() - 1;
+}
+
+std::string System::Properties::OSName() {
+	return _cached(_osName, [&]() {
+		const auto identity = OSDetails();
+		return identity->sysname + " " + identity->release;
+	});
+}
+
+std::string System::Properties::OSVersion() {
+	return _cached(_osVersion, [&]() {
+		return OSDetails()->version;
+	});
+}
+
+namespace {
+	/**
+	 * \brief  Opens a socket which receives the kernel's device hotplug
+	 *         uevents.
+	 * \return The socket, or \c -1 if it could not be opened, e.g. because
+	 *         netlink is unavailable in a sandbox.
+	 */
+	int openUeventSocket() noexcept {
+		const int fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC |
+			SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+		if (fd < 0) return -1;
+		struct sockaddr_nl address = {};
+		address.nl_family = AF_NETLINK;
+		address.nl_groups = 1;
+		if (::bind(fd, reinterpret_cast<struct sockaddr*>(&address),
+			sizeof(address))) {
+			::close(fd);
+			return -1;
+		}
+		return fd;
+	}
+
+	/**
+	 * \brief  Works out which properties a uevent may have changed.
+	 * \param  message The uevent, a list of \c NUL-separated \c KEY=value
+	 *                 pairs after a summary line.
+	 * \return Bitmask of the properties affected.
+	 */
+	std::uint32_t ueventProperties(const std::string_view message) noexcept {
+		std::string_view subsystem;
+		for (std::size_t pos = 0; pos < message.size();) {
+			std::size_t end = message.find('\0', pos);
+			if (end == std::string_view::npos) end = message.size();
+			const std::string_view pair = message.substr(pos, end - pos);
+			if (pair.substr(0, 10) == "SUBSYSTEM=") subsystem = pair.substr(10);
+			pos = end + 1;
+		}
+		if (subsystem == "cpu") {
+			return propertyBit(System::Property::CPUModel) |
+				propertyBit(System::Property::CPUArchitecture);
+		}
+		if (subsystem == "memory") {
+			return propertyBit(System::Property::RAMTotal);
+		}
+		if (subsystem == "pci" || subsystem == "drm") {
+			return propertyBit(System::Property::GPUVendor) |
+				propertyBit(System::Property::GPUName) |
+				propertyBit(System::Property::GPUDriver);
+		}
+		if (subsystem == "block") {
+			return propertyBit(System::Property::StorageTotal) |
+				propertyBit(System::Property::StorageFree);
+		}
+		return 0;
+	}
+}
+
+void System::Properties::_watch() noexcept {
+	// mountinfo raises POLLPRI when the mount table changes, until it's read
+	const std::filesystem::path path = _roots.mountinfo();
+	const int mounts = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	// hotplug events describe the live system, not another tree
+	const int uevents = _roots.live() ? openUeventSocket() : -1;
+	const auto drainMounts = [mounts]() {
+		char buffer[4096];
+		for (off_t offset = 0;;) {
+			const ssize_t got = ::pread(mounts, buffer, sizeof(buffer),
+				offset);
+			if (got <= 0) break;
+			offset += got;
+		}
+	};
+	if (mounts >= 0) drainMounts();
+
+	auto tick = std::chrono::steady_clock::now();
+	for (;;) {
+		const auto interval = std::chrono::milliseconds(_pollInterval.load());
+		const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+			tick + interval - std::chrono::steady_clock::now()).count();
+		struct pollfd fds[3] = { { _watchFd, POLLIN, 0 },
+			{ mounts, POLLPRI, 0 }, { uevents, POLLIN, 0 } };
+		if (::poll(fds, 3, static_cast<int>(std::max<std::int64_t>(wait, 0)))
+			< 0 && errno != EINTR) {
+			break;
+		}
+
+		std::uint32_t invalidated = 0;
+		if (fds[0].revents & POLLIN) {
+			std::uint64_t count = 0;
+			[[maybe_unused]] const ssize_t got = ::read(_watchFd, &count,
+				sizeof(count));
+		}
+		{
+			std::lock_guard<std::mutex> lock(_watchMutex);
+			if (_watchStopping) break;
+			_watchPending = false;
+		}
+		if (fds[1].revents & (POLLPRI | POLLERR)) {
+			drainMounts();
+			invalidated |= propertyBit(System::Property::StorageTotal) |
+				propertyBit(System::Property::StorageFree);
+		}
+		if (fds[2].revents & POLLIN) {
+			char message[8192];
+			for (;;) {
+				const ssize_t got = ::recv(uevents, message, sizeof(message),
+					0);
+				if (got <= 0) break;
+				invalidated |= ueventProperties(std::string_view(message,
+					static_cast<std::size_t>(got)));
+			}
+		}
+		if (std::chrono::steady_clock::now() >= tick + interval) {
+			tick = std::chrono::steady_clock::now();
+			invalidated |= propertyBit(System::Property::StorageFree);
+		}
+		try {
+			_notify(invalidated);
+		} catch (...) {
+			// the probes report their own failures through the snapshot
+		}
+	}
+	if (mounts >= 0) ::close(mounts);
+	if (uevents >= 0) ::close(uevents);
+}
+
+#endif
+
+//////////////////////////
+// MACOS IMPLEMENTATION //
+//////////////////////////
+#ifdef __APPLE__
+
+// macOS-only implementation goes here
+
+#endif
+
+///////////////////////////////////
+// CROSS-PLATFORM IMPLEMENTATION //
+///////////////////////////////////
+std::string System::Properties::RAMTotal(const System::Unit unit) {
+	return std::to_string(System::convert(RAMTotalBytes(), unit)) +
+		System::notation(unit);
+}
+
+std::string System::Properties::StorageTotal(const System::Unit unit) {
+	return std::to_string(System::convert(StorageTotalBytes(), unit)) +
+		System::notation(unit);
+}
+
+std::uint64_t System::Properties::StorageTotalBytes() {
+	// if at some point in the future I need to not use filesystem for whatever
+	// reason, then check out statvfs() - seems like it can't do total though...
+	return _cached(_storageTotal, [&]() {
+		return static_cast<std::uint64_t>(
+			std::filesystem::space(_roots.root).capacity);
+	});
+}
+
+std::string System::Properties::StorageFree(const System::Unit unit) {
+	return std::to_string(System::convert(StorageFreeBytes(), unit)) +
+		System::notation(unit);
+}
+
+std::uint64_t System::Properties::StorageFreeBytes() {
+	return _cached(_storageFree, [&]() {
+		return static_cast<std::uint64_t>(
+			std::filesystem::space(_roots.root).available);
+	});
+}
+
+void System::Prefetch::wait() const {
+	for (const auto& future : _futures) future.second.wait();
+}
+
+void System::Prefetch::wait(const System::Property property) const {
+	_futures.at(property).wait();
+}
+
+bool System::Prefetch::ready(const System::Property property) const {
+	return _futures.at(property).wait_for(std::chrono::seconds(0)) ==
+		std::future_status::ready;
+}
+
+void System::Prefetch::get(const System::Property property) const {
+	_futures.at(property).get();
+}
+
+std::shared_future<void> System::Prefetch::future(
+	const System::Property property) const {
+	return _futures.at(property);
+}
+
+System::Properties::Workers::~Workers() noexcept {
+	stop();
+}
+
+void System::Properties::Workers::submit(std::function<void()> task) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_threads.empty()) {
+		_stopping = false;
+		for (std::size_t i = 0; i < THREADS; ++i) {
+			_threads.emplace_back(&Workers::_run, this);
+		}
+	}
+	_tasks.push_back(std::move(task));
+	_signal.notify_one();
+}
+
+void System::Properties::Workers::stop() noexcept {
+	std::vector<std::thread> threads;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+		threads.swap(_threads);
+	}
+	_signal.notify_all();
+	for (auto& thread : threads) thread.join();
+}
+
+void System::Properties::Workers::_run() noexcept {
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_signal.wait(lock, [&]() { return _stopping || !_tasks.empty(); });
+			if (_tasks.empty()) break;
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+		task();
+	}
+}
+
+void System::Properties::_probe(const System::Property property) {
+	switch (property) {
+	case System::Property::CPUModel:
+		CPUModel();
+		break;
+	case System::Property::CPUArchitecture:
+		CPUArchitecture();
+		break;
+	case System::Property::RAMTotal:
+		RAMTotalBytes();
+		break;
+	case System::Property::OSName:
+		OSName();
+		break;
+	case System::Property::OSVersion:
+		OSVersion();
+		break;
+	case System::Property::GPUVendor:
+		GPUVendor();
+		break;
+	case System::Property::GPUName:
+		GPUName();
+		break;
+	case System::Property::GPUDriver:
+		GPUDriver();
+		break;
+	case System::Property::StorageTotal:
+		StorageTotalBytes();
+		break;
+	case System::Property::StorageFree:
+		StorageFreeBytes();
+		break;
+	}
+}
+
+System::Prefetch System::Properties::prefetch(
+	const std::initializer_list<System::Property> properties) {
+	System::Prefetch ret;
+	for (const auto property : properties) {
+		if (ret._futures.count(property)) continue;
+		auto promise = std::make_shared<std::promise<void>>();
+		ret._futures.emplace(property, promise->get_future().share());
+		_workers.submit([this, property, promise]() {
+			try {
+				_probe(property);
+				promise->set_value();
+			} catch (...) {
+				promise->set_exception(std::current_exception());
+			}
+		});
+	}
+	return ret;
+}
+
+System::Prefetch System::Properties::prefetchAll() {
+	// the slowest probes are queued first so that they start straight away
+	return prefetch({
+		System::Property::GPUDriver,
+		System::Property::GPUVendor,
+		System::Property::GPUName,
+		System::Property::StorageFree,
+		System::Property::StorageTotal,
+		System::Property::CPUModel,
+		System::Property::CPUArchitecture,
+		System::Property::RAMTotal,
+		System::Property::OSName,
+		System::Property::OSVersion
+	});
+}
+
+std::vector<System::Mount> System::Properties::mounts(
+	const System::MountOptions& options) {
+	return System::enumerateMounts(options, _roots.mountinfo(), _roots.root);
+}
+
+System::Mount System::Properties::mountOf(const std::filesystem::path& path,
+	const System::MountOptions& options) {
+	return System::mountOf(path, options, _roots.mountinfo(), _roots.root);
+}
+
+System::Properties& System::Properties::global() {
+	// leaked on purpose, so that it outlives every other static object
+	static System::Properties* const instance = new System::Properties();
+	return *instance;
+}
+
+const System::Roots& System::Properties::roots() const noexcept {
+	return _roots;
+}
+
+std::string System::Properties::GPUVendor() {
+	return _cached(_gpuVendor, [&]() {
+		const auto inventory = gpus();
+		requireDevice(inventory->ids, "a GPU");
+		return inventory->vendors.front();
+	});
+}
+
+std::string System::Properties::GPUName() {
+	return _cached(_gpuName, [&]() {
+		const auto inventory = gpus();
+		requireDevice(inventory->ids, "a GPU");
+		return inventory->names.front();
+	});
+}
+
+std::string System::Properties::GPUDriver() {
+	return _cached(_gpuDriver, [&]() {
+		const auto inventory = gpus();
+		requireDevice(inventory->ids, "a GPU");
+		if (inventory->driverVersions.front().empty()) {
+			throw std::system_error(std::make_error_code(
+				std::errc::no_such_file_or_directory),
+				"No driver is bound to GPU " + inventory->ids.front());
+		}
+		return inventory->driverVersions.front();
+	});
+}
+
+System::CPUFeatures System::Properties::CPUCapabilities() const noexcept {
+	return System::cpuFeatures();
+}
+
+System::Snapshot System::Properties::snapshot() {
+	prefetchAll().wait();
+	return _snapshot(ALL_PROPERTIES);
+}
+
+System::Snapshot System::Properties::_snapshot(const std::uint32_t properties) {
+	System::Snapshot ret;
+	const auto read = [&](const System::Property property, const auto& probe) {
+		if (!(properties & propertyBit(property))) return;
+		try {
+			probe();
+			ret.set(property);
+		} catch (const std::exception&) {}
+	};
+	read(System::Property::CPUModel, [&]() { ret.CPUModel = CPUModel(); });
+	read(System::Property::CPUArchitecture,
+		[&]() { ret.CPUArchitecture = CPUArchitecture(); });
+	read(System::Property::RAMTotal,
+		[&]() { ret.RAMTotal = RAMTotalBytes(); });
+	read(System::Property::OSName, [&]() { ret.OSName = OSName(); });
+	read(System::Property::OSVersion, [&]() { ret.OSVersion = OSVersion(); });
+	read(System::Property::GPUVendor, [&]() { ret.GPUVendor = GPUVendor(); });
+	read(System::Property::GPUName, [&]() { ret.GPUName = GPUName(); });
+	read(System::Property::GPUDriver, [&]() { ret.GPUDriver = GPUDriver(); });
+	read(System::Property::StorageTotal,
+		[&]() { ret.StorageTotal = StorageTotalBytes(); });
+	read(System::Property::StorageFree,
+		[&]() { ret.StorageFree = StorageFreeBytes(); });
+	return ret;
+}
+
+System::Properties::Subscription System::Properties::subscribe(
+	const std::initializer_list<System::Property> properties,
+	System::Properties::ChangeCallback callback) {
+	auto subscriber = std::make_shared<Subscriber>();
+	for (const auto property : properties) {
+		subscriber->properties |= propertyBit(property);
+	}
+	subscriber->onChange = std::move(callback);
+	return _subscribe(std::move(subscriber));
+}
+
+System::Properties::Subscription System::Properties::subscribe(
+	const System::Property property, const System::Threshold threshold,
+	const std::uint64_t limit, System::Properties::ThresholdCallback callback) {
+	if (property != System::Property::RAMTotal &&
+		property != System::Property::StorageTotal &&
+		property != System::Property::StorageFree) {
+		throw std::system_error(std::error_code(EINVAL, std::system_category()),
+			std::string("Property ") + propertyName(property) +
+			" is not a size");
+	}
+	auto subscriber = std::make_shared<Subscriber>();
+	subscriber->properties = propertyBit(property);
+	subscriber->onThreshold = std::move(callback);
+	subscriber->property = property;
+	subscriber->threshold = threshold;
+	subscriber->limit = limit;
+	return _subscribe(std::move(subscriber));
+}
+
+System::Properties::Subscription System::Properties::_subscribe(
+	std::shared_ptr<Subscriber> subscriber) {
+	std::lock_guard<std::mutex> lock(_watchMutex);
+	const Subscription ret = _nextSubscription++;
+	_subscribers.emplace(ret, std::move(subscriber));
+	_watchPending = true;
+	if (!_watcher.joinable()) {
+#ifdef __linux__
+		_watchFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+		if (_watchFd < 0) {
+			_subscribers.erase(ret);
+			throw std::system_error(std::error_code(errno,
+				std::system_category()), "Failed to create an eventfd");
+		}
+#endif
+		_watchStopping = false;
+		_watcher = std::thread(&Properties::_watch, this);
+	} else {
+		_wakeWatcher();
+	}
+	return ret;
+}
+
+void System::Properties::unsubscribe(const Subscription subscription)
+	noexcept {
+	std::lock_guard<std::mutex> lock(_watchMutex);
+	_subscribers.erase(subscription);
+}
+
+void System::Properties::setPollInterval(
+	const std::chrono::milliseconds interval) noexcept {
+	_pollInterval = interval.count();
+	std::lock_guard<std::mutex> lock(_watchMutex);
+	_wakeWatcher();
+}
+
+void System::Properties::_wakeWatcher() noexcept {
+#ifdef __linux__
+	if (_watchFd >= 0) {
+		const std::uint64_t one = 1;
+		[[maybe_unused]] const ssize_t written = ::write(_watchFd, &one,
+			sizeof(one));
+	}
+#endif
+	_watchWake.notify_all();
+}
+
+void System::Properties::_stopWatching() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(_watchMutex);
+		if (!_watcher.joinable()) return;
+		_watchStopping = true;
+		_wakeWatcher();
+	}
+	_watcher.join();
+#ifdef __linux__
+	std::lock_guard<std::mutex> lock(_watchMutex);
+	::close(_watchFd);
+	_watchFd = -1;
+#endif
+}
+
+void System::Properties::_invalidate(const std::uint32_t properties) noexcept {
+	const auto has = [&](const System::Property property) {
+		return (properties & propertyBit(property)) != 0;
+	};
+	if (has(System::Property::CPUModel) ||
+		has(System::Property::CPUArchitecture)) {
+#ifdef _WIN32
+		_wmi.invalidate(WMI_PROCESSOR);
+#elif __linux__
+		{
+			std::lock_guard<std::mutex> lock(_cpuInfoMutex);
+			_cpuInfo.reset();
+		}
+#endif
+		_cpuPackages.reset();
+		_cpuModel.reset();
+		_cpuArchitecture.reset();
+	}
+	if (has(System::Property::RAMTotal)) {
+#ifdef _WIN32
+		_wmi.invalidate(WMI_MEMORY);
+#endif
+		_memoryModules.reset();
+		_ramTotal.reset();
+	}
+	if (has(System::Property::OSName) || has(System::Property::OSVersion)) {
+#ifdef _WIN32
+		_wmi.invalidate(WMI_OS);
+#elif __linux__
+		_osDetails.reset();
+#endif
+		_osName.reset();
+		_osVersion.reset();
+	}
+	if (has(System::Property::GPUVendor) || has(System::Property::GPUName) ||
+		has(System::Property::GPUDriver)) {
+#ifdef _WIN32
+		_wmi.invalidate(WMI_VIDEO);
+#endif
+		_gpus.reset();
+		_gpuVendor.reset();
+		_gpuName.reset();
+		_gpuDriver.reset();
+	}
+	if (has(System::Property::StorageTotal)) _storageTotal.reset();
+	if (has(System::Property::StorageFree)) _storageFree.reset();
+}
+
+void System::Properties::_notify(const std::uint32_t invalidated) {
+	std::vector<std::shared_ptr<Subscriber>> subscribers;
+	std::uint32_t tracked = 0;
+	{
+		std::lock_guard<std::mutex> lock(_watchMutex);
+		for (const auto& subscriber : _subscribers) {
+			subscribers.push_back(subscriber.second);
+			tracked |= subscriber.second->properties;
+		}
+	}
+	if (subscribers.empty()) return;
+	_invalidate(invalidated & tracked);
+	const System::Snapshot now = _snapshot(tracked);
+
+	for (const auto& subscriber : subscribers) {
+		// the callbacks run unlocked, so skip any cancelled by an earlier one
+		{
+			std::lock_guard<std::mutex> lock(_watchMutex);
+			bool live = false;
+			for (const auto& other : _subscribers) {
+				if (other.second == subscriber) live = true;
+			}
+			if (!live) continue;
+		}
+		Subscriber& s = *subscriber;
+		try {
+			if (s.onThreshold) {
+				bool beyond = false;
+				if (now.has(s.property)) {
+					std::uint64_t value = now.StorageFree;
+					if (s.property == System::Property::RAMTotal) {
+						value = now.RAMTotal;
+					} else if (s.property == System::Property::StorageTotal) {
+						value = now.StorageTotal;
+					}
+					beyond = s.threshold == System::Threshold::Below ?
+						value < s.limit : value > s.limit;
+					if (beyond && !s.crossed) s.onThreshold(s.property, value);
+				}
+				s.crossed = beyond;
+			} else if (!s.primed) {
+				s.last = now;
+			} else {
+				std::vector<System::Property> changed = s.last.diff(now);
+				changed.erase(std::remove_if(changed.begin(), changed.end(),
+					[&](const System::Property property) {
+						return !(s.properties & propertyBit(property));
+					}), changed.end());
+				if (!changed.empty()) {
+					const System::Snapshot before = std::move(s.last);
+					s.last = now;
+					s.onChange(before, now, changed);
+				}
+			}
+		} catch (...) {
+			// a throwing callback mustn't take the background thread down
+		}
+		s.primed = true;
+	}
+}
+
+void System::Properties::invalidate() noexcept {
+#ifdef _WIN32
+	_wmi.invalidate();
+#elif __linux__
+	{
+		std::lock_guard<std::mutex> lock(_cpuInfoMutex);
+		_cpuInfo.reset();
+	}
+#endif
+	for (auto cache : _caches) cache->reset();
+}
+
+void System::Properties::setVolatileLifetime(
+	const std::chrono::milliseconds lifetime) noexcept {
+	_volatileLifetime = lifetime.count();
+}
+
+std::vector<System::ProbeStats> System::Properties::probeStats() const {
+	std::vector<System::ProbeStats> ret;
+#ifndef _SYSTEM_PROPERTIES_NO_INSTRUMENTATION
+	ret.reserve(_caches.size());
+	for (const auto cache : _caches) ret.push_back(cache->stats());
+#endif
+	return ret;
+}
+
+void System::Properties::resetProbeStats() noexcept {
+	for (auto cache : _caches) cache->resetStats();
+}
+
+void System::Properties::setTraceHook(System::TraceHook hook) {
+#ifndef _SYSTEM_PROPERTIES_NO_INSTRUMENTATION
+	std::shared_ptr<const System::TraceHook> replacement;
+	if (hook) {
+		replacement =
+			std::make_shared<const System::TraceHook>(std::move(hook));
+	}
+	std::lock_guard<std::mutex> lock(_traceMutex);
+	_traceHook = std::move(replacement);
+	_tracing = static_cast<bool>(_traceHook);
+#else
+	(void)hook;
+#endif
+}
+
+System::ProbeStats System::Properties::CacheEntry::stats() const noexcept {
+	System::ProbeStats ret;
+	ret.name = _name;
+#ifndef _SYSTEM_PROPERTIES_NO_INSTRUMENTATION
+	constexpr auto relaxed = std::memory_order_relaxed;
+	ret.hits = _hits.load(relaxed);
+	ret.misses = _misses.load(relaxed);
+	ret.calls = ret.hits + ret.misses;
+	ret.failures = _failures.load(relaxed);
+	ret.totalTime = std::chrono::nanoseconds(_totalTime.load(relaxed));
+	ret.maxTime = std::chrono::nanoseconds(_maxTime.load(relaxed));
+	for (std::size_t i = 0; i < System::ProbeStats::BUCKETS; ++i) {
+		ret.histogram[i] = _histogram[i].load(relaxed);
+	}
+#endif
+	return ret;
+}
+
+void System::Properties::CacheEntry::resetStats() noexcept {
+#ifndef _SYSTEM_PROPERTIES_NO_INSTRUMENTATION
+	constexpr auto relaxed = std::memory_order_relaxed;
+	_hits.store(0, relaxed);
+	_misses.store(0, relaxed);
+	_failures.store(0, relaxed);
+	_totalTime.store(0, relaxed);
+	_maxTime.store(0, relaxed);
+	for (auto& bucket : _histogram) bucket.store(0, relaxed);
+#endif
+}
+
+#ifndef _SYSTEM_PROPERTIES_NO_INSTRUMENTATION
+void System::Properties::CacheEntry::_record(const bool hit, const bool failed,
+	const std::chrono::nanoseconds duration, const System::TraceHook* hook)
+	noexcept {
+	constexpr auto relaxed = std::memory_order_relaxed;
+	if (hit) {
+		_hits.fetch_add(1, relaxed);
+	} else {
+		_misses.fetch_add(1, relaxed);
+		if (failed) _failures.fetch_add(1, relaxed);
+		const auto ns = static_cast<std::uint64_t>(duration.count());
+		_totalTime.fetch_add(ns, relaxed);
+		auto max = _maxTime.load(relaxed);
+		while (ns > max && !_maxTime.compare_exchange_weak(max, ns, relaxed)) {}
+		// bucket i holds runs of [2^(i-1), 2^i) microseconds
+		std::size_t bucket = 0;
+		for (auto us = ns / 1000; us && bucket + 1 < _histogram.size();
+			us >>= 1) ++bucket;
+		_histogram[bucket].fetch_add(1, relaxed);
+	}
+	if (!hook) return;
+	try {
+		System::ProbeEvent event;
+		event.name = _name;
+		event.hit = hit;
+		event.failed = failed;
+		event.duration = duration;
+		(*hook)(event);
+	} catch (...) {
+		// a throwing hook mustn't fail the accessor it is tracing
+	}
+}
+#endif
@@ -22,24 +22,46 @@ SOFTWARE.*/
 
 #pragma once
 
+#include "SystemCPUFeatures.hpp"
+#include <cstdint>
+#include <array>
 #include <string>
+#include <string_view>
 #include <system_error>
 #include <filesystem>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
 
 #ifdef _WIN32
-	#include <variant>
-	#include <vector>
 	#ifdef _WIN32_DCOM
 		#define _SYSTEM_PROPERTIES_DO_NOT_UNDEF
 	#endif
 	#ifndef _WIN32_DCOM
 		#define _WIN32_DCOM
 	#endif
+	// windows.h would otherwise define min() and max() macros, which break
+	// std::min(), std::max() and std::numeric_limits<T>::max()
+	#ifdef NOMINMAX
+		#define _SYSTEM_PROPERTIES_KEEP_NOMINMAX
+	#else
+		#define NOMINMAX
+	#endif
 	#include <comdef.h>
 	#include <WbemIdl.h>
 	#pragma comment(lib, "wbemuuid.lib")
 #elif __linux__
-	#include <sys/utsname.h>
+	#include <poll.h>
 #elif __APPLE__
 	// macOS-only includes go here
 #endif
@@ -55,249 +77,4408 @@ SOFTWARE.*/
 namespace System {
 	/**
 	 * \brief   The units of memory available for the client to use.
+	 * \details \c KB, \c MB and \c GB are binary units (multiples of 1024),
+	 *          written as \c KB, \c MB and \c GB. The \c Decimal units are
+	 *          multiples of 1000, as used by drive manufacturers, and carry a
+	 *          \c "(decimal)" suffix so they can't be mistaken for the others.
 	 * \remarks If more units are added, do not forget to update
-	 *          \c System::convert() and \c System::notation() accordingly.
+	 *          \c System::divisor() and \c System::notation() accordingly.
 	 */
 	enum class Unit {
 		Bytes,
 		KB,
 		MB,
-		GB
+		GB,
+		DecimalKB,
+		DecimalMB,
+		DecimalGB
 	};
 
+	/**
+	 * \brief  This function retrieves the number of bytes in one of a given unit
+	 *         of memory.
+	 * \param  unit The unit of memory.
+	 * \return The number of bytes in the unit.
+	 */
+	constexpr std::uint64_t divisor(const System::Unit unit) noexcept {
+		switch (unit) {
+		case System::Unit::KB:
+			return 1024;
+		case System::Unit::MB:
+			return 1024 * 1024;
+		case System::Unit::GB:
+			return 1024 * 1024 * 1024;
+		case System::Unit::DecimalKB:
+			return 1000;
+		case System::Unit::DecimalMB:
+			return 1000 * 1000;
+		case System::Unit::DecimalGB:
+			return 1000 * 1000 * 1000;
+		default:
+			return 1;
+		}
+	}
+
 	/**
 	 * \brief  This function converts a given number of bytes into a given unit of
 	 *         memory.
 	 * \param  bytes The bytes to convert, in \c System::Unit::Bytes.
 	 * \param  unit  The unit of memory to convert the given number of bytes to.
-	 * \return The number of bytes, converted.
+	 * \return The number of bytes, converted. Any fractional part is truncated,
+	 *         so 15.9GB becomes 15GB: use \c System::convertExact() to keep it.
+	 */
+	constexpr std::uint64_t convert(const std::uint64_t bytes,
+		const System::Unit unit) noexcept {
+		return bytes / System::divisor(unit);
+	}
+
+	/**
+	 * \brief A number of bytes converted into a unit of memory without losing
+	 *        its fractional part.
+	 */
+	struct Quantity {
+		/**
+		 * \brief The whole number of units.
+		 */
+		std::uint64_t whole = 0;
+
+		/**
+		 * \brief The bytes left over, which make up the fractional part.
+		 */
+		std::uint64_t remainder = 0;
+
+		/**
+		 * \brief The number of bytes in one unit.
+		 */
+		std::uint64_t divisor = 1;
+
+		/**
+		 * \brief  Retrieves the quantity as a floating-point number.
+		 * \return \c whole \c + \c remainder \c / \c divisor.
+		 */
+		constexpr double value() const noexcept {
+			return static_cast<double>(whole) +
+				static_cast<double>(remainder) / static_cast<double>(divisor);
+		}
+	};
+
+	/**
+	 * \brief  This function converts a given number of bytes into a given unit of
+	 *         memory, keeping the fractional part.
+	 * \param  bytes The bytes to convert, in \c System::Unit::Bytes.
+	 * \param  unit  The unit of memory to convert the given number of bytes to.
+	 * \return The number of bytes, converted. The original number of bytes can
+	 *         be recovered from it exactly.
 	 */
-	std::uint64_t convert(const std::uint64_t bytes, const System::Unit unit)
-		noexcept;
+	constexpr System::Quantity convertExact(const std::uint64_t bytes,
+		const System::Unit unit) noexcept {
+		const std::uint64_t d = System::divisor(unit);
+		return System::Quantity{ bytes / d, bytes % d, d };
+	}
 
 	/**
 	 * \brief  This function retrieves the notation for the given unit of memory.
 	 * \param  unit The unit of memory to retrieve the notation of.
-	 * \return The notation of the given memory unit.
+	 * \return The notation of the given memory unit. Binary units keep their
+	 *         plain names (\c "GB"), and decimal units add a suffix
+	 *         (\c "GB (decimal)"), so the two can't be confused.
 	 */
 	std::string notation(const System::Unit unit) noexcept;
 
 	/**
-	 * \brief   This class lets the client query the computer for hardware and
-	 *          software information.
-	 * \warning Due to limitations within the Windows implementation, this class
-	 *          should only be instantiated \b once, and kept alive for as long as
-	 *          necessary, before it is disposed of. It should \b not be
-	 *          instantiated more than once in a program, regardless of platform!
-	 * \warning In addition, within the Windows implementation, this library makes
-	 *          use of the COM library. Within the constructor, the following
-	 *          functions are called: \c CoInitializeEx(),
-	 *          \c CoInitializeSecurity(), \c CoCreateInstance(),
-	 *          \c IWbemLocator::ConnectServer(), and \c CoSetProxyBlanket().
-	 *          Microsoft in their Windows API documentation instructs the
-	 *          programmer to avoid calling most of these functions more than once
-	 *          in a program, so if you call these functions at all within your own
-	 *          code, you will likely not be able to use this library verbatim. You
-	 *          can extract the relevant code for yourself, or you may amend the
-	 *          constructor to fit around your application, if this is the case.
+	 * \brief   An immutable, parsed snapshot of a Linux \c /proc/cpuinfo file.
+	 * \details The file is read once, and each block of fields is stored in its
+	 *          own key/value table, one per logical CPU. Fields which hold the
+	 *          same value on every logical CPU of a physical package (such as
+	 *          \c "model name" and \c "flags") are additionally collected into
+	 *          one table per package, so that package-level queries do not have
+	 *          to visit every logical CPU. Blocks which do not describe a logical
+	 *          CPU (such as the trailing \c "Hardware" block on ARM) are stored
+	 *          as global fields.\n
+	 *          All lookups are O(1).
 	 */
-	class Properties {
+	class CPUInfo {
 	public:
 		/**
-		 * \brief   Initialises the connection between the program and the
-		 *          computer.
-		 * \warning If this constructor throws, \b do \b not use the resulting
-		 *          object, as it will be unsafe to do so (accessing NULL pointers
-		 *          internally, etc.).
-		 * \throws  std::system_error if initialisation failed. An OS-specific
-		 *          code and error string will be generated.
+		 * \brief A key/value table of CPU fields.
 		 */
-		Properties();
+		typedef std::unordered_map<std::string, std::string> Fields;
 
 		/**
-		 * \brief Safely destroys the connection between the program and the
-		 *        computer.
+		 * \brief  Parses the contents of a \c /proc/cpuinfo file.
+		 * \param  text The full contents of the file.
+		 * \return The parsed snapshot.
 		 */
-		~Properties() noexcept;
+		static System::CPUInfo parse(const std::string_view text);
 
 		/**
-		 * \brief  Retrieves the CPU model name.
-		 * \return User-friendly name of the CPU.
-		 * \throws std::system_error if the the request failed. An OS-specific
-		 *         code and error string will be generated.
+		 * \brief  Reads and parses a \c /proc/cpuinfo file in a single pass.
+		 * \param  path The path of the file to read.
+		 * \return The parsed snapshot.
+		 * \throws std::system_error if the file could not be read.
 		 */
-		std::string CPUModel();
+		static System::CPUInfo load(
+			const std::filesystem::path& path = "/proc/cpuinfo");
 
 		/**
-		 * \brief  Retrieves the CPU architecture.
-		 * \return Architecture of the CPU.
-		 * \throws std::system_error if the the request failed. An OS-specific
-		 *         code and error string will be generated.
+		 * \brief  Retrieves the number of logical CPUs in the snapshot.
+		 * \return The number of logical CPUs.
 		 */
-		std::string CPUArchitecture();
+		std::size_t logicalCount() const noexcept;
 
 		/**
-		 * \brief   Retrieves the total installed RAM available.
-		 * \details On the Windows implementation, the total RAM installed will be
-		 *          returned.\n
-		 *          On the Linux implementation, only the RAM available for use at
-		 *          the time of calling will be returned. This could mean that 16GB
-		 *          of RAM is installed, for example, but only 8GB of it is readily
-		 *          available.
-		 * \param   unit The unit of memory to return the total RAM in. By default,
-		 *               it is \c System::Unit::GB.
-		 * \return  The total RAM installed.
-		 * \throws  std::system_error if the the request failed. An OS-specific
-		 *          code and error string will be generated.
+		 * \brief  Retrieves the number of physical packages in the snapshot.
+		 * \return The number of packages. CPUs which do not report a
+		 *         \c "physical id" are all counted as belonging to one package.
 		 */
-		std::string RAMTotal(const System::Unit unit = System::Unit::GB);
+		std::size_t packageCount() const noexcept;
 
 		/**
-		 * \brief  Retrieves the name of the OS the machine is running.
-		 * \return User-friendly OS name.
-		 * \throws std::system_error if the the request failed. An OS-specific
-		 *         code and error string will be generated.
+		 * \brief  Retrieves every field of a logical CPU.
+		 * \param  index Index of the logical CPU, in file order.
+		 * \return The fields of the logical CPU.
+		 * \throws std::out_of_range if \c index is out of range.
 		 */
-		std::string OSName();
+		const Fields& logical(const std::size_t index) const;
 
 		/**
-		 * \brief  Retrieves the version of the OS the machine is running.
-		 * \return Version string.
-		 * \throws std::system_error if the the request failed. An OS-specific
-		 *         code and error string will be generated.
+		 * \brief  Retrieves the fields shared by every logical CPU of a package.
+		 * \param  index Index of the package, in ascending \c "physical id"
+		 *               order.
+		 * \return The fields of the package.
+		 * \throws std::out_of_range if \c index is out of range.
 		 */
-		std::string OSVersion();
+		const Fields& package(const std::size_t index) const;
 
 		/**
-		 * \brief   Retrieves the vendor of the currently installed GPU.
-		 * \details Note that on Linux, the \c lshw program is used to retrieve
-		 *          this information. If the program is not installed, this
-		 *          method will throw.
-		 * \return  The name of the vendor of the installed GPU.
-		 * \throws  std::system_error if the the request failed. An OS-specific
-		 *          code and error string will be generated.
+		 * \brief  Retrieves the fields which do not belong to any logical CPU.
+		 * \return The global fields.
 		 */
-		std::string GPUVendor();
+		const Fields& global() const noexcept;
 
 		/**
-		 * \brief   Retrieves the name of the currently installed GPU.
-		 * \details Note that on Linux, the \c lshw program is used to retrieve
-		 *          this information. If the program is not installed, this
-		 *          method will throw.
-		 * \return  User-friendly name of the installed GPU.
-		 * \throws  std::system_error if the the request failed. An OS-specific
-		 *          code and error string will be generated.
+		 * \brief   Finds a field describing the machine's CPU.
+		 * \details The first package is searched first, followed by the first
+		 *          logical CPU, followed by the global fields.
+		 * \param   key The name of the field, e.g. \c "model name".
+		 * \return  Pointer to the field's value, or \c nullptr if it could not
+		 *          be found.
 		 */
-		std::string GPUName();
+		const std::string* find(const std::string& key) const noexcept;
+	private:
+		/**
+		 * \brief The fields of each logical CPU.
+		 */
+		std::vector<Fields> _logical;
 
 		/**
-		 * \brief   Retrieves the version of the driver the installed GPU is using.
-		 * \details Note that on Linux, the \c lshw and \c modinfo programs are
-		 *          used to retrieve this information. If the programs are not
-		 *          installed, this method will throw.
-		 * \return  Version string.
-		 * \throws  std::system_error if the the request failed. An OS-specific
-		 *          code and error string will be generated.
+		 * \brief The deduplicated fields of each package.
 		 */
-		std::string GPUDriver();
+		std::vector<Fields> _packages;
 
 		/**
-		 * \brief  Retrieves the capacity of the drive the program is running on.
-		 * \param  unit The unit of memory to return the capacity in. By default,
-		 *              it is \c System::Unit::GB.
-		 * \return The capacity of the drive.
-		 * \throws std::filesystem_error if the the request failed. An OS-specific
-		 *         code and error string will be generated.
+		 * \brief The fields which do not belong to a logical CPU.
 		 */
-		std::string StorageTotal(const System::Unit unit = System::Unit::GB);
+		Fields _global;
+	};
+
+	/**
+	 * \brief Identifies each property which \c System::Properties can retrieve.
+	 */
+	enum class Property {
+		CPUModel,
+		CPUArchitecture,
+		RAMTotal,
+		OSName,
+		OSVersion,
+		GPUVendor,
+		GPUName,
+		GPUDriver,
+		StorageTotal,
+		StorageFree
+	};
+
+	/**
+	 * \brief   Handle to a set of properties being probed in the background.
+	 * \details Returned by \c Properties::prefetch() and
+	 *          \c Properties::prefetchAll(). Once a property is ready, its
+	 *          accessor returns the cached result without probing again (subject
+	 *          to its \c System::CachePolicy).
+	 */
+	class Prefetch {
+	public:
+		/**
+		 * \brief Waits for every property in the set to finish being probed.
+		 */
+		void wait() const;
 
 		/**
-		 * \brief  Retrieves the amount of free space on the drive the program is
-		 *         running on.
-		 * \param  unit The unit of memory to return the free space in. By default,
-		 *              it is \c System::Unit::GB.
-		 * \return The free space of the drive.
-		 * \throws std::filesystem_error if the the request failed. An OS-specific
-		 *         code and error string will be generated.
+		 * \brief  Waits for a single property to finish being probed.
+		 * \param  property The property to wait for.
+		 * \throws std::out_of_range if the property isn't in the set.
 		 */
-		std::string StorageFree(const System::Unit unit = System::Unit::GB);
+		void wait(const System::Property property) const;
+
+		/**
+		 * \brief  Checks if a property has finished being probed.
+		 * \param  property The property to check.
+		 * \return \c TRUE if the property is ready, \c FALSE if it is still
+		 *         being probed.
+		 * \throws std::out_of_range if the property isn't in the set.
+		 */
+		bool ready(const System::Property property) const;
+
+		/**
+		 * \brief  Waits for a single property, and rethrows the error it failed
+		 *         with, if it failed.
+		 * \param  property The property to wait for.
+		 * \throws std::out_of_range if the property isn't in the set.
+		 * \throws Whatever the property's accessor threw, if it failed.
+		 */
+		void get(const System::Property property) const;
+
+		/**
+		 * \brief  Retrieves the future which becomes ready when a property has
+		 *         been probed.
+		 * \param  property The property to retrieve the future of.
+		 * \return The property's future. It holds the error the property failed
+		 *         with, if it failed.
+		 * \throws std::out_of_range if the property isn't in the set.
+		 */
+		std::shared_future<void> future(const System::Property property) const;
 	private:
-#ifdef _WIN32
+		friend class Properties;
+
 		/**
-		 * \brief  Make a request to the WMI and retrieve the output.
-		 * \param  className  Name of the WMI class containing the information to
-		 *                    retrieve.
-		 * \param  objectName Name of the WMI object within the WMI class
-		 *                    containing the information to retrieve.
-		 * \param  datatype   The CIM data type of the information to retrieve.
-		 * \return The output received from the WMI.
-		 * \throws std::system_error if the the request failed. A
-		 *         Windows-specific code and error string will be generated.
+		 * \brief The future of each property in the set.
 		 */
-		std::variant<std::vector<std::int64_t>, std::vector<std::uint64_t>,
-			std::vector<std::string>>
-			_wmiRequest(const char* className, const char* objectName,
-				const CIMTYPE datatype);
+		std::unordered_map<System::Property, std::shared_future<void>> _futures;
+	};
 
+	/**
+	 * \brief How long the result of a property probe is cached for.
+	 */
+	enum class CachePolicy {
 		/**
-		 * \brief   Pointer to the WMI locator.
-		 * \details This will be manually released in the destructor.
+		 * \brief   For facts which don't change while the program is running, such
+		 *          as the CPU model or OS name.
+		 * \details The property is probed once, and its result, or the error it
+		 *          failed with, is kept until \c Properties::invalidate() is
+		 *          called.
 		 */
-		IWbemLocator* _pLoc = 0;
+		Static,
 
 		/**
-		 * \brief   Pointer to the WMI services.
-		 * \details This will be manually released in the destructor.
+		 * \brief   For figures which change over time, such as free storage.
+		 * \details The result, or the error, is kept until it is older than the
+		 *          lifetime set via \c Properties::setVolatileLifetime().
 		 */
-		IWbemServices* _pSvc = 0;
-#elif __linux__
+		Volatile
+	};
+
+	/**
+	 * \brief   The counters kept for one cached probe of a
+	 *          \c System::Properties object.
+	 * \details Every accessor call is either a cache hit, which returns the
+	 *          cached result, or a miss, which runs the probe. Only misses are
+	 *          timed.
+	 */
+	struct ProbeStats {
 		/**
-		 * \brief  Make a query for CPU information.
-		 * \param  objectName Name of the piece of CPU information to retrieve.
-		 * \return The piece of CPU information requested.
-		 * \throws std::system_error if the the request failed. A file I/O code and
-		 *         error string will be generated.
+		 * \brief   The number of buckets in \c histogram.
+		 * \details Bucket \c 0 counts runs which took less than a microsecond,
+		 *          bucket \c i counts runs which took between \c 2^(i-1) and
+		 *          \c 2^i microseconds, and the last bucket also counts every
+		 *          slower run.
 		 */
-		std::string _cpuRequest(const std::string& objectName);
+		static constexpr std::size_t BUCKETS = 24;
 
 		/**
-		 * \brief  Retrieve information about the OS.
-		 * \return Structure containing Linux-specific OS information.
-		 * \throws std::system_error if the the request failed. A Linux-specific
-		 *         code and error string will be generated.
+		 * \brief The name of the accessor which owns the probe, e.g.
+		 *        \c "CPUModel".
 		 */
-		struct utsname _osRequest();
+		std::string_view name;
 
 		/**
-		 * \brief   Executes a command on the bash and retrieves the output.
-		 * \details Many thanks to <a href="https://stackoverflow.com/a/478960"
-		 *          target=_blank>waqas</a> for the code here.
-		 * \param   cmd The command to execute.
-		 * \return  The output of the executed command.
-		 * \throws  std::system_error if the the request failed. A Linux-specific
-		 *          code and error string will be generated.
+		 * \brief The number of times the accessor was called.
 		 */
-		std::string _exec(const char* cmd);
+		std::uint64_t calls = 0;
 
 		/**
-		 * \brief  Retrieves GPU information.
-		 * \param  name Name of the GPU information to search for.
-		 * \return The information.
-		 * \throws  std::system_error if the the request failed. A Linux-specific
-		 *          code and error string will be generated.
+		 * \brief The number of calls which returned a cached result.
 		 */
-		std::string _gpuRequest(const std::string& name);
-#elif __APPLE__
-		// any macOS-only data required goes here
-		// also any macOS-only helper methods should be declared here
-#endif
+		std::uint64_t hits = 0;
+
+		/**
+		 * \brief The number of calls which ran the probe.
+		 */
+		std::uint64_t misses = 0;
+
+		/**
+		 * \brief The number of probe runs which threw.
+		 */
+		std::uint64_t failures = 0;
+
+		/**
+		 * \brief The time spent running the probe, across every miss.
+		 */
+		std::chrono::nanoseconds totalTime{ 0 };
+
+		/**
+		 * \brief The longest single run of the probe.
+		 */
+		std::chrono::nanoseconds maxTime{ 0 };
+
+		/**
+		 * \brief The number of probe runs in each latency bucket.
+		 */
+		std::array<std::uint64_t, BUCKETS> histogram{};
 	};
-}
 
-#ifdef _WIN32
-	// just in case leaving this in could cause problems in another's Windows code
-	// idk if this is even a useful thing to do, but it can't hurt... hopefully...
-	#ifndef _SYSTEM_PROPERTIES_DO_NOT_UNDEF
-		#undef _WIN32_DCOM
+	/**
+	 * \brief Describes a single accessor call, for \c System::TraceHook.
+	 */
+	struct ProbeEvent {
+		/**
+		 * \brief The name of the accessor, as in \c System::ProbeStats::name.
+		 */
+		std::string_view name;
+
+		/**
+		 * \brief \c TRUE if the call returned a cached result.
+		 */
+		bool hit = false;
+
+		/**
+		 * \brief \c TRUE if the call threw, whether or not it ran the probe.
+		 */
+		bool failed = false;
+
+		/**
+		 * \brief How long the probe took to run, or zero on a cache hit.
+		 */
+		std::chrono::nanoseconds duration{ 0 };
+	};
+
+	/**
+	 * \brief   Receives every accessor call made to a \c System::Properties
+	 *          object, once its cache has been unlocked.
+	 * \details It is called on the thread which made the call, so it should be
+	 *          quick. Whatever it throws is ignored.
+	 */
+	typedef std::function<void(const System::ProbeEvent&)> TraceHook;
+
+	/**
+	 * \brief Which side of a limit a threshold subscription fires on.
+	 */
+	enum class Threshold {
+		/**
+		 * \brief Fires when the value drops below the limit, e.g. when free
+		 *        storage runs low.
+		 */
+		Below,
+
+		/**
+		 * \brief Fires when the value rises above the limit.
+		 */
+		Above
+	};
+
+	/**
+	 * \brief Describes a display controller found on the PCI bus.
+	 */
+	struct GPUDevice {
+		/**
+		 * \brief The PCI address of the device, e.g. \c "0000:01:00.0".
+		 */
+		std::string address;
+
+		/**
+		 * \brief The PCI vendor ID.
+		 */
+		std::uint16_t vendorID = 0;
+
+		/**
+		 * \brief The PCI device ID.
+		 */
+		std::uint16_t deviceID = 0;
+
+		/**
+		 * \brief The PCI class code, e.g. \c 0x030000 for a VGA controller.
+		 */
+		std::uint32_t classCode = 0;
+
+		/**
+		 * \brief   User-friendly name of the vendor.
+		 * \details If no \c pci.ids database could be found, or the vendor is
+		 *          not listed in it, this will be the hexadecimal vendor ID.
+		 */
+		std::string vendor;
+
+		/**
+		 * \brief   User-friendly name of the device.
+		 * \details If no \c pci.ids database could be found, or the device is
+		 *          not listed in it, this will be the hexadecimal device ID.
+		 */
+		std::string name;
+
+		/**
+		 * \brief The name of the kernel driver bound to the device, or an empty
+		 *        string if no driver is bound.
+		 */
+		std::string driver;
+
+		/**
+		 * \brief   The version reported by the driver's kernel module.
+		 * \details This is empty if the module does not report a version, which
+		 *          is usually the case for drivers shipped with the kernel.
+		 */
+		std::string driverVersion;
+
+		/**
+		 * \brief \c TRUE if the firmware used this device as the boot display.
+		 */
+		bool bootVGA = false;
+	};
+
+	/**
+	 * \brief   Enumerates the display controllers on the PCI bus via sysfs.
+	 * \details Every device under \c <sysfs>/bus/pci/devices with a PCI class
+	 *          of \c 0x03xxxx is reported. No child processes are spawned.\n
+	 *          The boot display is listed first, followed by the remaining
+	 *          devices in PCI address order.
+	 * \param   sysfs  The root of the sysfs tree to read from.
+	 * \param   pciIDs The \c pci.ids databases to resolve vendor and device
+	 *                 names from. The first one which exists is used.
+	 * \return  The display controllers found. This is empty if the machine has
+	 *          no GPU, or if the PCI bus could not be enumerated.
+	 */
+	std::vector<System::GPUDevice> enumerateGPUs(
+		const std::filesystem::path& sysfs = "/sys",
+		const std::vector<std::filesystem::path>& pciIDs = {
+			"/usr/share/hwdata/pci.ids", "/usr/share/misc/pci.ids",
+			"/usr/share/pci.ids" });
+
+	/**
+	 * \brief   The GPUs of the machine.
+	 * \details The GPUs are stored as a structure of arrays: element \c i of
+	 *          every vector describes the GPU \c ids[i]. The primary GPU is
+	 *          listed first, and the order is otherwise stable.
+	 */
+	struct GPUInventory {
+		/**
+		 * \brief  Finds a GPU by its ID.
+		 * \param  id The GPU's ID.
+		 * \return The GPU's index, or \c -1 if it isn't listed.
+		 */
+		std::ptrdiff_t find(const std::string_view id) const noexcept;
+
+		/**
+		 * \brief The ID of each GPU: its PCI address on Linux, e.g.
+		 *        \c "0000:01:00.0", and its PnP device ID on Windows.
+		 */
+		std::vector<std::string> ids;
+
+		/**
+		 * \brief User-friendly name of each GPU's vendor.
+		 */
+		std::vector<std::string> vendors;
+
+		/**
+		 * \brief User-friendly name of each GPU.
+		 */
+		std::vector<std::string> names;
+
+		/**
+		 * \brief   The version of each GPU's driver.
+		 * \details This is empty if no driver is bound to the GPU. On Linux,
+		 *          drivers shipped with the kernel report the kernel release.
+		 */
+		std::vector<std::string> driverVersions;
+	};
+
+	/**
+	 * \brief   The physical CPU packages of the machine.
+	 * \details The packages are stored as a structure of arrays: element \c i
+	 *          of every vector describes the package \c ids[i]. The packages
+	 *          are listed in ascending ID order.
+	 */
+	struct CPUPackageInventory {
+		/**
+		 * \brief  Finds a package by its ID.
+		 * \param  id The package's ID.
+		 * \return The package's index, or \c -1 if it isn't listed.
+		 */
+		std::ptrdiff_t find(const std::string_view id) const noexcept;
+
+		/**
+		 * \brief The ID of each package: its \c "physical id" on Linux, e.g.
+		 *        \c "0", and its device ID on Windows, e.g. \c "CPU0".
+		 */
+		std::vector<std::string> ids;
+
+		/**
+		 * \brief User-friendly name of each package's model.
+		 */
+		std::vector<std::string> models;
+
+		/**
+		 * \brief The vendor of each package, e.g. \c "GenuineIntel".
+		 */
+		std::vector<std::string> vendors;
+
+		/**
+		 * \brief The number of physical cores in each package.
+		 */
+		std::vector<std::uint32_t> cores;
+
+		/**
+		 * \brief The number of logical CPUs in each package.
+		 */
+		std::vector<std::uint32_t> threads;
+	};
+
+	/**
+	 * \brief   The RAM modules installed in the machine.
+	 * \details The modules are stored as a structure of arrays: element \c i
+	 *          of every vector describes the module \c ids[i]. Empty slots
+	 *          are not listed. Fields the firmware doesn't report are empty,
+	 *          or \c 0.
+	 */
+	struct MemoryModuleInventory {
+		/**
+		 * \brief  Finds a module by its ID.
+		 * \param  id The module's ID.
+		 * \return The index of the first module with that ID, or \c -1 if it
+		 *         isn't listed.
+		 */
+		std::ptrdiff_t find(const std::string_view id) const noexcept;
+
+		/**
+		 * \brief The slot each module is installed in, e.g. \c "DIMM_A1".
+		 */
+		std::vector<std::string> ids;
+
+		/**
+		 * \brief The bank of each module's slot, e.g. \c "BANK 0".
+		 */
+		std::vector<std::string> banks;
+
+		/**
+		 * \brief The capacity of each module, in bytes.
+		 */
+		std::vector<std::uint64_t> sizes;
+
+		/**
+		 * \brief The rated speed of each module, in MT/s.
+		 */
+		std::vector<std::uint32_t> speeds;
+
+		/**
+		 * \brief The type of each module, e.g. \c "DDR4".
+		 */
+		std::vector<std::string> types;
+
+		/**
+		 * \brief The manufacturer of each module.
+		 */
+		std::vector<std::string> manufacturers;
+
+		/**
+		 * \brief The part number of each module.
+		 */
+		std::vector<std::string> partNumbers;
+	};
+
+	/**
+	 * \brief   The physical disks attached to the machine.
+	 * \details The disks are stored as a structure of arrays: element \c i of
+	 *          every vector describes the disk \c ids[i]. Partitions and
+	 *          virtual devices, such as loop devices and RAM disks, are not
+	 *          listed.
+	 */
+	struct DiskInventory {
+		/**
+		 * \brief  Finds a disk by its ID.
+		 * \param  id The disk's ID.
+		 * \return The disk's index, or \c -1 if it isn't listed.
+		 */
+		std::ptrdiff_t find(const std::string_view id) const noexcept;
+
+		/**
+		 * \brief The ID of each disk: its kernel name on Linux, e.g.
+		 *        \c "nvme0n1", and its device ID on Windows, e.g.
+		 *        <tt>\\\\.\\PHYSICALDRIVE0</tt>.
+		 */
+		std::vector<std::string> ids;
+
+		/**
+		 * \brief The model of each disk, or an empty string if the disk
+		 *        doesn't report one.
+		 */
+		std::vector<std::string> models;
+
+		/**
+		 * \brief The capacity of each disk, in bytes.
+		 */
+		std::vector<std::uint64_t> sizes;
+
+		/**
+		 * \brief \c TRUE for each disk whose media can be removed, or which is
+		 *        attached externally.
+		 */
+		std::vector<bool> removable;
+	};
+
+#ifdef __linux__
+	/**
+	 * \brief   Enumerates the RAM modules from the SMBIOS tables via sysfs.
+	 * \details Every memory device structure under
+	 *          \c <sysfs>/firmware/dmi/entries is parsed. These are usually
+	 *          only readable by root, so the result is empty for other users.
+	 * \param   sysfs The root of the sysfs tree to read from.
+	 * \return  The installed modules, in SMBIOS order.
+	 */
+	System::MemoryModuleInventory enumerateMemoryModules(
+		const std::filesystem::path& sysfs = "/sys");
+
+	/**
+	 * \brief   Enumerates the physical disks via sysfs.
+	 * \details Every device under \c <sysfs>/block which is backed by a
+	 *          hardware device is reported, in name order.
+	 * \param   sysfs The root of the sysfs tree to read from.
+	 * \return  The disks found.
+	 */
+	System::DiskInventory enumerateDisks(
+		const std::filesystem::path& sysfs = "/sys");
+#endif
+
+	/**
+	 * \brief   A read-only view of a list of logical CPU IDs, in ascending order.
+	 * \details The IDs are stored by the \c System::Topology the list was
+	 *          retrieved from, and the view is only valid for as long as that
+	 *          topology is alive.
+	 */
+	class CPUList {
+	public:
+		/**
+		 * \brief Constructs an empty list.
+		 */
+		CPUList() noexcept = default;
+
+		/**
+		 * \brief Constructs a view of a range of IDs.
+		 * \param first Pointer to the first ID.
+		 * \param last  Pointer to one past the last ID.
+		 */
+		CPUList(const std::uint32_t* first, const std::uint32_t* last) noexcept :
+			_first(first), _last(last) {}
+
+		/**
+		 * \brief  Retrieves the first ID.
+		 * \return Pointer to the first ID.
+		 */
+		const std::uint32_t* begin() const noexcept { return _first; }
+
+		/**
+		 * \brief  Retrieves the end of the list.
+		 * \return Pointer to one past the last ID.
+		 */
+		const std::uint32_t* end() const noexcept { return _last; }
+
+		/**
+		 * \brief  Retrieves the number of IDs in the list.
+		 * \return The number of IDs.
+		 */
+		std::size_t size() const noexcept {
+			return static_cast<std::size_t>(_last - _first);
+		}
+
+		/**
+		 * \brief  Checks if the list is empty.
+		 * \return \c TRUE if the list has no IDs.
+		 */
+		bool empty() const noexcept { return _first == _last; }
+
+		/**
+		 * \brief  Retrieves an ID by its position in the list.
+		 * \param  index The position of the ID. It must be in range.
+		 * \return The ID.
+		 */
+		std::uint32_t operator[](const std::size_t index) const noexcept {
+			return _first[index];
+		}
+
+		/**
+		 * \brief  Checks if the list contains a CPU, with a binary search.
+		 * \param  cpu The ID of the CPU.
+		 * \return \c TRUE if the CPU is in the list.
+		 */
+		bool contains(const std::uint32_t cpu) const noexcept;
+	private:
+		/**
+		 * \brief Pointer to the first ID.
+		 */
+		const std::uint32_t* _first = nullptr;
+
+		/**
+		 * \brief Pointer to one past the last ID.
+		 */
+		const std::uint32_t* _last = nullptr;
+	};
+
+	/**
+	 * \brief   A read-only view of the caches a CPU can use, as indices for
+	 *          \c System::Topology::cacheInfo(), from the lowest level up.
+	 * \details Unlike a \c System::CPUList, the indices aren't sorted. The view
+	 *          is only valid for as long as the topology it was retrieved from
+	 *          is alive.
+	 */
+	class CacheList {
+	public:
+		/**
+		 * \brief Constructs an empty list.
+		 */
+		CacheList() noexcept = default;
+
+		/**
+		 * \brief Constructs a view of a range of indices.
+		 * \param first Pointer to the first index.
+		 * \param last  Pointer to one past the last index.
+		 */
+		CacheList(const std::uint32_t* first, const std::uint32_t* last)
+			noexcept : _first(first), _last(last) {}
+
+		/**
+		 * \brief  Retrieves the first index.
+		 * \return Pointer to the first index.
+		 */
+		const std::uint32_t* begin() const noexcept { return _first; }
+
+		/**
+		 * \brief  Retrieves the end of the list.
+		 * \return Pointer to one past the last index.
+		 */
+		const std::uint32_t* end() const noexcept { return _last; }
+
+		/**
+		 * \brief  Retrieves the number of caches in the list.
+		 * \return The number of caches.
+		 */
+		std::size_t size() const noexcept {
+			return static_cast<std::size_t>(_last - _first);
+		}
+
+		/**
+		 * \brief  Checks if the list is empty.
+		 * \return \c TRUE if the list has no caches.
+		 */
+		bool empty() const noexcept { return _first == _last; }
+
+		/**
+		 * \brief  Retrieves an index by its position in the list.
+		 * \param  index The position of the index. It must be in range.
+		 * \return The cache's index.
+		 */
+		std::uint32_t operator[](const std::size_t index) const noexcept {
+			return _first[index];
+		}
+	private:
+		/**
+		 * \brief Pointer to the first index.
+		 */
+		const std::uint32_t* _first = nullptr;
+
+		/**
+		 * \brief Pointer to one past the last index.
+		 */
+		const std::uint32_t* _last = nullptr;
+	};
+
+	/**
+	 * \brief Describes a single CPU cache, which may be shared by several
+	 *        logical CPUs.
+	 */
+	struct CacheInfo {
+		/**
+		 * \brief The kinds of cache.
+		 */
+		enum class Type {
+			Data,
+			Instruction,
+			Unified
+		};
+
+		/**
+		 * \brief The level of the cache, e.g. \c 3 for an L3 cache.
+		 */
+		std::uint32_t level = 0;
+
+		/**
+		 * \brief The kind of cache.
+		 */
+		Type type = Type::Unified;
+
+		/**
+		 * \brief The size of the cache, in bytes.
+		 */
+		std::uint64_t size = 0;
+
+		/**
+		 * \brief The size of a cache line, in bytes.
+		 */
+		std::uint32_t lineSize = 0;
+	};
+
+	/**
+	 * \brief   The CPU topology of the machine: packages, cores, SMT threads,
+	 *          caches and NUMA nodes.
+	 * \details The topology is built once, from Linux's
+	 *          \c /sys/devices/system/cpu and \c /sys/devices/system/node trees,
+	 *          and is then immutable. Every CPU list it stores (SMT siblings,
+	 *          cache sharing sets and NUMA node CPU lists) is packed into a single
+	 *          array, and per-CPU data is stored in flat arrays indexed by CPU ID,
+	 *          so every query is O(1) and allocation-free.\n
+	 *          Only online CPUs are described. Queries about any other CPU ID
+	 *          return empty lists, \c nullptr or \c -1.
+	 */
+	class Topology {
+	public:
+		/**
+		 * \brief  Builds the topology from a sysfs tree.
+		 * \param  sysfs The root of the sysfs tree to read from.
+		 * \return The topology.
+		 * \throws std::system_error if no online CPU could be found.
+		 */
+		static System::Topology load(const std::filesystem::path& sysfs = "/sys");
+
+		/**
+		 * \brief  Retrieves every online logical CPU.
+		 * \return The IDs of every online CPU.
+		 */
+		System::CPUList cpus() const noexcept;
+
+		/**
+		 * \brief  Retrieves the number of physical packages (sockets).
+		 * \return The number of packages.
+		 */
+		std::size_t packageCount() const noexcept;
+
+		/**
+		 * \brief  Retrieves the number of physical cores, across every package.
+		 * \return The number of physical cores.
+		 */
+		std::size_t coreCount() const noexcept;
+
+		/**
+		 * \brief  Retrieves the package a CPU belongs to.
+		 * \param  cpu The ID of the CPU.
+		 * \return The \c physical_package_id of the CPU, or \c -1.
+		 */
+		std::int32_t package(const std::uint32_t cpu) const noexcept;
+
+		/**
+		 * \brief  Retrieves the physical core a CPU belongs to.
+		 * \param  cpu The ID of the CPU.
+		 * \return The \c core_id of the CPU, which is only unique within its
+		 *         package, or \c -1.
+		 */
+		std::int32_t core(const std::uint32_t cpu) const noexcept;
+
+		/**
+		 * \brief  Retrieves the NUMA node a CPU belongs to.
+		 * \param  cpu The ID of the CPU.
+		 * \return The ID of the CPU's NUMA node, or \c -1.
+		 */
+		std::int32_t node(const std::uint32_t cpu) const noexcept;
+
+		/**
+		 * \brief  Retrieves the SMT threads which share a CPU's physical core.
+		 * \param  cpu The ID of the CPU.
+		 * \return The CPU's thread siblings, including itself.
+		 */
+		System::CPUList threadSiblings(const std::uint32_t cpu) const noexcept;
+
+		/**
+		 * \brief  Retrieves the caches a CPU can use, from the lowest level up.
+		 * \param  cpu The ID of the CPU.
+		 * \return The indices of the caches, for use with \c cacheInfo().
+		 */
+		System::CacheList caches(const std::uint32_t cpu) const noexcept;
+
+		/**
+		 * \brief  Retrieves a cache of a CPU.
+		 * \param  cpu   The ID of the CPU.
+		 * \param  level The level of the cache.
+		 * \param  type  The kind of cache. At level 1, CPUs usually have separate
+		 *               data and instruction caches, whereas higher levels are
+		 *               usually unified.
+		 * \return Pointer to the cache's information, or \c nullptr if the CPU
+		 *         has no such cache.
+		 */
+		const System::CacheInfo* cache(const std::uint32_t cpu,
+			const std::uint32_t level, const System::CacheInfo::Type type =
+			System::CacheInfo::Type::Unified) const noexcept;
+
+		/**
+		 * \brief   Retrieves the CPUs which share a cache with a CPU, e.g. the
+		 *          "cores sharing L3 with CPU N".
+		 * \details At level 1, the data cache is used.
+		 * \param   cpu   The ID of the CPU.
+		 * \param   level The level of the cache.
+		 * \return  The CPUs sharing the cache, including \c cpu, or an empty list
+		 *          if the CPU has no cache at that level.
+		 */
+		System::CPUList sharingCache(const std::uint32_t cpu,
+			const std::uint32_t level) const noexcept;
+
+		/**
+		 * \brief  Retrieves the number of distinct caches in the machine.
+		 * \return The number of caches.
+		 */
+		std::size_t cacheCount() const noexcept;
+
+		/**
+		 * \brief  Retrieves a cache's information by its index.
+		 * \param  index The index of the cache, as returned by \c caches().
+		 * \return The cache's information.
+		 * \throws std::out_of_range if \c index is out of range.
+		 */
+		const System::CacheInfo& cacheInfo(const std::size_t index) const;
+
+		/**
+		 * \brief  Retrieves the CPUs which share a cache, by the cache's index.
+		 * \param  index The index of the cache, as returned by \c caches().
+		 * \return The CPUs sharing the cache.
+		 * \throws std::out_of_range if \c index is out of range.
+		 */
+		System::CPUList cacheCPUs(const std::size_t index) const;
+
+		/**
+		 * \brief  Retrieves every NUMA node.
+		 * \return The IDs of every NUMA node. Machines without NUMA report a
+		 *         single node \c 0.
+		 */
+		System::CPUList nodes() const noexcept;
+
+		/**
+		 * \brief  Retrieves the online CPUs of a NUMA node.
+		 * \param  node The ID of the node.
+		 * \return The CPUs of the node.
+		 */
+		System::CPUList nodeCPUs(const std::uint32_t node) const noexcept;
+
+		/**
+		 * \brief  Retrieves the memory attached to a NUMA node.
+		 * \param  node The ID of the node.
+		 * \return The node's total memory, in bytes, or \c 0 if it is unknown.
+		 */
+		std::uint64_t nodeMemory(const std::uint32_t node) const noexcept;
+	private:
+		/**
+		 * \brief  Retrieves a packed list.
+		 * \param  list The index of the list, or \c -1.
+		 * \return The list, or an empty list if \c list is \c -1.
+		 */
+		System::CPUList _list(const std::int32_t list) const noexcept;
+
+		/**
+		 * \brief  Packs a list of IDs into \c _members.
+		 * \param  ids The IDs to pack.
+		 * \return The index of the list.
+		 */
+		std::int32_t _pack(const std::vector<std::uint32_t>& ids);
+
+		/**
+		 * \brief Every packed list, back to back.
+		 */
+		std::vector<std::uint32_t> _members;
+
+		/**
+		 * \brief Where each packed list starts in \c _members. There is one
+		 *        more element than there are lists.
+		 */
+		std::vector<std::uint32_t> _offsets = { 0 };
+
+		/**
+		 * \brief The packed list of every online CPU.
+		 */
+		std::int32_t _cpus = -1;
+
+		/**
+		 * \brief The packed list of every NUMA node.
+		 */
+		std::int32_t _nodes = -1;
+
+		/**
+		 * \brief The package of each CPU, indexed by CPU ID.
+		 */
+		std::vector<std::int32_t> _package;
+
+		/**
+		 * \brief The core of each CPU, indexed by CPU ID.
+		 */
+		std::vector<std::int32_t> _core;
+
+		/**
+		 * \brief The NUMA node of each CPU, indexed by CPU ID.
+		 */
+		std::vector<std::int32_t> _node;
+
+		/**
+		 * \brief The packed list of thread siblings of each CPU, indexed by CPU
+		 *        ID.
+		 */
+		std::vector<std::int32_t> _siblings;
+
+		/**
+		 * \brief The packed list of caches of each CPU, indexed by CPU ID.
+		 */
+		std::vector<std::int32_t> _cpuCaches;
+
+		/**
+		 * \brief Every distinct cache.
+		 */
+		std::vector<System::CacheInfo> _caches;
+
+		/**
+		 * \brief The packed list of CPUs sharing each cache.
+		 */
+		std::vector<std::int32_t> _cacheCPUs;
+
+		/**
+		 * \brief The packed list of CPUs of each NUMA node, indexed by node ID.
+		 */
+		std::vector<std::int32_t> _nodeCPUs;
+
+		/**
+		 * \brief The memory of each NUMA node, indexed by node ID.
+		 */
+		std::vector<std::uint64_t> _nodeMemory;
+
+		/**
+		 * \brief The number of packages.
+		 */
+		std::size_t _packageCount = 0;
+
+		/**
+		 * \brief The number of physical cores.
+		 */
+		std::size_t _coreCount = 0;
+	};
+
+	/**
+	 * \brief   A snapshot of the memory figures reported by Linux's
+	 *          \c /proc/meminfo.
+	 * \details Every size is in bytes. Fields which the kernel doesn't report
+	 *          are left at \c 0.
+	 */
+	struct MemoryStats {
+		/**
+		 * \brief Usable RAM, i.e. physical RAM minus reserved memory and the
+		 *        kernel's binary code (\c MemTotal).
+		 */
+		std::uint64_t total = 0;
+
+		/**
+		 * \brief RAM which is completely unused (\c MemFree).
+		 */
+		std::uint64_t free = 0;
+
+		/**
+		 * \brief Estimate of the RAM available for starting new applications
+		 *        without swapping (\c MemAvailable).
+		 */
+		std::uint64_t available = 0;
+
+		/**
+		 * \brief RAM used by block device buffers (\c Buffers).
+		 */
+		std::uint64_t buffers = 0;
+
+		/**
+		 * \brief RAM used by the page cache (\c Cached).
+		 */
+		std::uint64_t cached = 0;
+
+		/**
+		 * \brief Swapped-out memory which is also still in RAM
+		 *        (\c SwapCached).
+		 */
+		std::uint64_t swapCached = 0;
+
+		/**
+		 * \brief Recently used memory (\c Active).
+		 */
+		std::uint64_t active = 0;
+
+		/**
+		 * \brief Memory which is a candidate for reclaiming (\c Inactive).
+		 */
+		std::uint64_t inactive = 0;
+
+		/**
+		 * \brief Total swap space (\c SwapTotal).
+		 */
+		std::uint64_t swapTotal = 0;
+
+		/**
+		 * \brief Unused swap space (\c SwapFree).
+		 */
+		std::uint64_t swapFree = 0;
+
+		/**
+		 * \brief Memory waiting to be written back to disk (\c Dirty).
+		 */
+		std::uint64_t dirty = 0;
+
+		/**
+		 * \brief Shared memory and tmpfs usage (\c Shmem).
+		 */
+		std::uint64_t shmem = 0;
+
+		/**
+		 * \brief Kernel slab allocations (\c Slab).
+		 */
+		std::uint64_t slab = 0;
+
+		/**
+		 * \brief The part of \c slab which can be reclaimed (\c SReclaimable).
+		 */
+		std::uint64_t slabReclaimable = 0;
+
+		/**
+		 * \brief Memory which may be committed before allocations fail under
+		 *        strict overcommit (\c CommitLimit).
+		 */
+		std::uint64_t commitLimit = 0;
+
+		/**
+		 * \brief Memory currently committed (\c Committed_AS).
+		 */
+		std::uint64_t committed = 0;
+
+		/**
+		 * \brief The number of huge pages in the pool (\c HugePages_Total).
+		 */
+		std::uint64_t hugePagesTotal = 0;
+
+		/**
+		 * \brief The number of unallocated huge pages (\c HugePages_Free).
+		 */
+		std::uint64_t hugePagesFree = 0;
+
+		/**
+		 * \brief The number of huge pages reserved but not yet allocated
+		 *        (\c HugePages_Rsvd).
+		 */
+		std::uint64_t hugePagesReserved = 0;
+
+		/**
+		 * \brief The number of surplus huge pages (\c HugePages_Surp).
+		 */
+		std::uint64_t hugePagesSurplus = 0;
+
+		/**
+		 * \brief The default huge page size (\c Hugepagesize).
+		 */
+		std::uint64_t hugePageSize = 0;
+
+		/**
+		 * \brief Memory used by huge pages of every size (\c Hugetlb).
+		 */
+		std::uint64_t hugetlb = 0;
+
+		/**
+		 * \brief   Parses the contents of a \c /proc/meminfo file.
+		 * \details This does not allocate. Unknown fields are ignored.
+		 * \param   text  The contents of the file.
+		 * \param   stats The structure to store the figures in. Every field is
+		 *                reset before the text is parsed.
+		 * \return  \c TRUE if the text contained \c MemTotal, \c FALSE if it
+		 *          doesn't look like a \c /proc/meminfo file.
+		 */
+		static bool parse(const std::string_view text, System::MemoryStats& stats)
+			noexcept;
+	};
+
+#ifdef __linux__
+	/**
+	 * \brief   Samples \c /proc/meminfo repeatedly without allocating.
+	 * \details The file is opened once, and every sample is a single \c pread()
+	 *          into a buffer which is reused between samples. This makes the
+	 *          sampler cheap enough to poll at high frequencies.\n
+	 *          A sampler is not thread-safe: each thread should use its own.
+	 */
+	class MemorySampler {
+	public:
+		/**
+		 * \brief  Opens the file to sample.
+		 * \param  path The path of the \c meminfo file.
+		 * \throws std::system_error if the file could not be opened.
+		 */
+		explicit MemorySampler(
+			const std::filesystem::path& path = "/proc/meminfo");
+
+		/**
+		 * \brief Closes the file.
+		 */
+		~MemorySampler() noexcept;
+
+		/**
+		 * \brief Samplers own a file descriptor, so they can't be copied.
+		 */
+		MemorySampler(const MemorySampler&) = delete;
+
+		/**
+		 * \brief Samplers own a file descriptor, so they can't be copied.
+		 */
+		MemorySampler& operator=(const MemorySampler&) = delete;
+
+		/**
+		 * \brief Transfers the file descriptor and buffer to a new sampler.
+		 */
+		MemorySampler(MemorySampler&& other) noexcept;
+
+		/**
+		 * \brief Transfers the file descriptor and buffer to this sampler.
+		 */
+		MemorySampler& operator=(MemorySampler&& other) noexcept;
+
+		/**
+		 * \brief   Reads and parses the file.
+		 * \details The buffer only grows (once) if the file outgrows it.
+		 * \return  The new sample. The reference stays valid until the next
+		 *          call.
+		 * \throws  std::system_error if the file could not be read or parsed.
+		 */
+		const System::MemoryStats& sample();
+
+		/**
+		 * \brief  Retrieves the last sample taken.
+		 * \return The last sample, which is all zeroes before the first call to
+		 *         \c sample().
+		 */
+		const System::MemoryStats& last() const noexcept;
+	private:
+		/**
+		 * \brief The file descriptor of the sampled file, or \c -1.
+		 */
+		int _fd = -1;
+
+		/**
+		 * \brief The buffer which the file is read into.
+		 */
+		std::vector<char> _buffer;
+
+		/**
+		 * \brief The last sample taken.
+		 */
+		System::MemoryStats _stats;
+	};
+#endif
+
+	/**
+	 * \brief   CPU utilisation measured between two samples.
+	 * \details The per-CPU figures are stored as a structure of arrays: element
+	 *          \c i of every vector describes the logical CPU \c ids[i]. Each
+	 *          fraction is between \c 0 and \c 1, and is the share of the
+	 *          sampling interval the CPU spent in that state.
+	 */
+	struct CPUUsage {
+		/**
+		 * \brief The fraction of time every CPU was busy, on average.
+		 */
+		double utilization = 0.0;
+
+		/**
+		 * \brief The fraction of time every CPU spent in user mode, on average.
+		 */
+		double user = 0.0;
+
+		/**
+		 * \brief The fraction of time every CPU spent in kernel mode, including
+		 *        interrupts, on average.
+		 */
+		double system = 0.0;
+
+		/**
+		 * \brief The fraction of time every CPU was idle waiting on I/O, on
+		 *        average.
+		 */
+		double iowait = 0.0;
+
+		/**
+		 * \brief The fraction of time stolen by the hypervisor, on average.
+		 */
+		double steal = 0.0;
+
+		/**
+		 * \brief The ID of each logical CPU.
+		 */
+		std::vector<std::uint32_t> ids;
+
+		/**
+		 * \brief The fraction of time each CPU was busy.
+		 */
+		std::vector<double> coreUtilization;
+
+		/**
+		 * \brief The fraction of time each CPU spent in user mode.
+		 */
+		std::vector<double> coreUser;
+
+		/**
+		 * \brief The fraction of time each CPU spent in kernel mode.
+		 */
+		std::vector<double> coreSystem;
+
+		/**
+		 * \brief The fraction of time each CPU was idle waiting on I/O.
+		 */
+		std::vector<double> coreIOWait;
+
+		/**
+		 * \brief The fraction of time stolen from each CPU by the hypervisor.
+		 */
+		std::vector<double> coreSteal;
+
+		/**
+		 * \brief The current frequency of each CPU, in kHz, or \c 0 if it is
+		 *        unknown.
+		 */
+		std::vector<std::uint64_t> frequency;
+	};
+
+#ifdef __linux__
+	/**
+	 * \brief   Samples CPU utilisation from \c /proc/stat, and CPU frequencies
+	 *          from cpufreq, without allocating.
+	 * \details Every file is opened once, in the constructor, and read with
+	 *          \c pread() into a buffer which is reused between samples. The
+	 *          result is a \c System::CPUUsage sized to the number of logical
+	 *          CPUs online at construction; CPUs which come online later are
+	 *          ignored, and CPUs which go offline report zeroes.\n
+	 *          A sampler is not thread-safe: each thread should use its own.
+	 */
+	class CPUSampler {
+	public:
+		/**
+		 * \brief  Opens the files to sample.
+		 * \param  procfs      The root of the procfs tree to read from.
+		 * \param  sysfs       The root of the sysfs tree to read from.
+		 * \param  frequencies \c TRUE to sample each CPU's frequency, which
+		 *                     costs one extra \c pread() per CPU per sample.
+		 * \throws std::system_error if \c /proc/stat could not be opened or
+		 *         parsed.
+		 */
+		explicit CPUSampler(const std::filesystem::path& procfs = "/proc",
+			const std::filesystem::path& sysfs = "/sys",
+			const bool frequencies = true);
+
+		/**
+		 * \brief Closes the files.
+		 */
+		~CPUSampler() noexcept;
+
+		/**
+		 * \brief Samplers own file descriptors, so they can't be copied.
+		 */
+		CPUSampler(const CPUSampler&) = delete;
+
+		/**
+		 * \brief Samplers own file descriptors, so they can't be copied.
+		 */
+		CPUSampler& operator=(const CPUSampler&) = delete;
+
+		/**
+		 * \brief   Takes a new sample and computes the utilisation since the
+		 *          previous one.
+		 * \details The first sample measures the utilisation since boot.
+		 * \return  The utilisation. The reference stays valid until the next
+		 *          call.
+		 * \throws  std::system_error if \c /proc/stat could not be read.
+		 */
+		const System::CPUUsage& sample();
+
+		/**
+		 * \brief  Retrieves the last utilisation computed.
+		 * \return The last utilisation computed.
+		 */
+		const System::CPUUsage& last() const noexcept;
+	private:
+		/**
+		 * \brief  Reads \c /proc/stat into the buffer.
+		 * \return View of the part of the file which was read.
+		 * \throws std::system_error if the file could not be read.
+		 */
+		std::string_view _read();
+
+		/**
+		 * \brief The file descriptor of \c /proc/stat.
+		 */
+		int _statFd = -1;
+
+		/**
+		 * \brief The file descriptor of each CPU's \c scaling_cur_freq, or
+		 *        \c -1 if it is unavailable.
+		 */
+		std::vector<int> _frequencyFds;
+
+		/**
+		 * \brief The buffer which \c /proc/stat is read into.
+		 */
+		std::vector<char> _buffer;
+
+		/**
+		 * \brief Maps a logical CPU ID to its index in the result, or \c -1.
+		 */
+		std::vector<int> _index;
+
+		/**
+		 * \brief   The jiffies counted by the previous sample, in rows of
+		 *          \c FIELDS.
+		 * \details Row \c 0 is the aggregate, and row \c i+1 is CPU \c ids[i].
+		 */
+		std::vector<std::uint64_t> _previous;
+
+		/**
+		 * \brief Scratch space for the jiffies of the current sample.
+		 */
+		std::vector<std::uint64_t> _current;
+
+		/**
+		 * \brief The last utilisation computed.
+		 */
+		System::CPUUsage _usage;
+	};
+#endif
+
+	/**
+	 * \brief Describes a mounted filesystem and its capacity.
+	 */
+	struct Mount {
+		/**
+		 * \brief The outcome of querying a mount's capacity.
+		 */
+		enum class Status {
+			/**
+			 * \brief The capacity figures are valid.
+			 */
+			OK,
+
+			/**
+			 * \brief The query failed: see \c error.
+			 */
+			Failed,
+
+			/**
+			 * \brief The query did not finish within the timeout, e.g. because
+			 *        the mount is an unresponsive network share.
+			 */
+			TimedOut
+		};
+
+		/**
+		 * \brief The path the filesystem is mounted at.
+		 */
+		std::string mountPoint;
+
+		/**
+		 * \brief   The directory within the filesystem which forms the root of
+		 *          the mount.
+		 * \details This is \c / unless a subdirectory was bind-mounted. Only
+		 *          Linux reports it; elsewhere it is left empty.
+		 */
+		std::string root;
+
+		/**
+		 * \brief   The source of the filesystem.
+		 * \details This is usually a device, such as \c /dev/sda1, or a remote
+		 *          share, such as \c server:/export.
+		 */
+		std::string source;
+
+		/**
+		 * \brief The type of the filesystem, e.g. \c ext4 or \c NTFS.
+		 */
+		std::string fsType;
+
+		/**
+		 * \brief The per-mount options, e.g. \c rw,relatime.
+		 */
+		std::string options;
+
+		/**
+		 * \brief The major number of the filesystem's device.
+		 */
+		std::uint32_t major = 0;
+
+		/**
+		 * \brief The minor number of the filesystem's device.
+		 */
+		std::uint32_t minor = 0;
+
+		/**
+		 * \brief The capacity of the filesystem, in bytes.
+		 */
+		std::uint64_t total = 0;
+
+		/**
+		 * \brief The free space on the filesystem, in bytes.
+		 */
+		std::uint64_t free = 0;
+
+		/**
+		 * \brief The free space available to unprivileged users, in bytes.
+		 */
+		std::uint64_t available = 0;
+
+		/**
+		 * \brief The number of inodes on the filesystem.
+		 */
+		std::uint64_t inodesTotal = 0;
+
+		/**
+		 * \brief The number of free inodes on the filesystem.
+		 */
+		std::uint64_t inodesFree = 0;
+
+		/**
+		 * \brief The outcome of querying the capacity figures.
+		 */
+		Status status = Status::OK;
+
+		/**
+		 * \brief The reason the query failed, if \c status is \c Failed.
+		 */
+		std::error_code error;
+	};
+
+	/**
+	 * \brief Controls how mounted filesystems are queried.
+	 */
+	struct MountOptions {
+		/**
+		 * \brief   \c TRUE to query the mounts concurrently.
+		 * \details When this is \c TRUE, each mount is queried on a small pool
+		 *          of helper threads, and a mount which does not respond within
+		 *          \c timeout is reported as \c Mount::Status::TimedOut instead
+		 *          of blocking the whole inventory. When it is \c FALSE, the
+		 *          mounts are queried one by one on the calling thread, and the
+		 *          timeout is ignored.
+		 */
+		bool parallel = true;
+
+		/**
+		 * \brief How long to wait for each mount. Zero waits forever.
+		 */
+		std::chrono::milliseconds timeout = std::chrono::milliseconds(2000);
+
+		/**
+		 * \brief \c TRUE to include pseudo filesystems which have no capacity,
+		 *        such as \c proc, \c sysfs and \c cgroup2.
+		 */
+		bool includePseudo = false;
+	};
+
+	/**
+	 * \brief   Parses the contents of a Linux \c /proc/self/mountinfo file.
+	 * \details Only the mount metadata is filled in: the capacity figures are
+	 *          left at zero.
+	 * \param   text The contents of the file.
+	 * \return  Every mount listed in the file, in order.
+	 */
+	std::vector<System::Mount> parseMountInfo(const std::string_view text);
+
+	/**
+	 * \brief   Enumerates the mounted filesystems and queries their capacity.
+	 * \details On Linux, the mounts are read from \c mountinfo, and each one is
+	 *          queried with \c statvfs(). On Windows, every logical drive is
+	 *          reported.
+	 * \param   options   Controls how the mounts are queried.
+	 * \param   mountinfo The \c mountinfo file to read, on Linux.
+	 * \param   root      The directory the mount points are relative to, on
+	 *                    Linux, e.g. \c /host if the host's root filesystem is
+	 *                    bind-mounted there. The mount points are reported as
+	 *                    listed in \c mountinfo.
+	 * \return  The mounts, in mount order.
+	 * \throws  std::system_error if the mounts could not be enumerated.
+	 */
+	std::vector<System::Mount> enumerateMounts(
+		const System::MountOptions& options = System::MountOptions(),
+		const std::filesystem::path& mountinfo = "/proc/self/mountinfo",
+		const std::filesystem::path& root = "/");
+
+	/**
+	 * \brief   Finds the filesystem a path is stored on, and queries its
+	 *          capacity.
+	 * \param   path      The path to look up, relative to \c root. It must
+	 *                    exist. Symlinks are resolved as if \c root were the
+	 *                    root directory, so they can't lead out of it.
+	 * \param   options   Controls how the mount is queried. Only \c parallel and
+	 *                    \c timeout are used.
+	 * \param   mountinfo The \c mountinfo file to read, on Linux.
+	 * \param   root      The directory the mount points are relative to, on
+	 *                    Linux.
+	 * \return  The mount the path is stored on.
+	 * \throws  std::system_error if the path or the mounts could not be
+	 *          resolved.
+	 */
+	System::Mount mountOf(const std::filesystem::path& path,
+		const System::MountOptions& options = System::MountOptions(),
+		const std::filesystem::path& mountinfo = "/proc/self/mountinfo",
+		const std::filesystem::path& root = "/");
+
+	/**
+	 * \brief   Block device I/O measured between two samples.
+	 * \details The figures are stored as a structure of arrays: element \c i of
+	 *          every vector describes the device \c names[i]. Every device the
+	 *          kernel lists is reported, including partitions, which are also
+	 *          counted within their whole disk.
+	 */
+	struct DiskUsage {
+		/**
+		 * \brief   Finds a device by its number.
+		 * \param   major The device's major number.
+		 * \param   minor The device's minor number.
+		 * \return  The device's index, or \c -1 if it isn't listed.
+		 */
+		std::ptrdiff_t find(const std::uint32_t major,
+			const std::uint32_t minor) const noexcept;
+
+		/**
+		 * \brief   Finds the device a filesystem is mounted from.
+		 * \details Filesystems which aren't backed by a single block device,
+		 *          such as \c tmpfs, network shares and \c btrfs volumes, are
+		 *          not found.
+		 * \param   mount The mount, as returned by
+		 *                \c System::enumerateMounts().
+		 * \return  The device's index, or \c -1 if it isn't listed.
+		 */
+		std::ptrdiff_t find(const System::Mount& mount) const noexcept;
+
+		/**
+		 * \brief The length of the sampling interval, in seconds.
+		 */
+		double interval = 0.0;
+
+		/**
+		 * \brief The name of each device, e.g. \c sda or \c nvme0n1p2.
+		 */
+		std::vector<std::string> names;
+
+		/**
+		 * \brief The major number of each device.
+		 */
+		std::vector<std::uint32_t> major;
+
+		/**
+		 * \brief The minor number of each device.
+		 */
+		std::vector<std::uint32_t> minor;
+
+		/**
+		 * \brief The number of reads each device completed per second.
+		 */
+		std::vector<double> reads;
+
+		/**
+		 * \brief The number of writes each device completed per second.
+		 */
+		std::vector<double> writes;
+
+		/**
+		 * \brief The number of bytes read from each device per second.
+		 */
+		std::vector<double> readBytes;
+
+		/**
+		 * \brief The number of bytes written to each device per second.
+		 */
+		std::vector<double> writeBytes;
+
+		/**
+		 * \brief The average number of requests queued on or in flight to each
+		 *        device.
+		 */
+		std::vector<double> queueDepth;
+
+		/**
+		 * \brief The fraction of time each device was busy with at least one
+		 *        request, between \c 0 and \c 1.
+		 */
+		std::vector<double> utilization;
+
+		/**
+		 * \brief The number of requests in flight to each device when the
+		 *        sample was taken.
+		 */
+		std::vector<std::uint64_t> inFlight;
+	};
+
+#ifdef __linux__
+	/**
+	 * \brief   Samples block device I/O from \c /proc/diskstats without
+	 *          allocating.
+	 * \details The file is opened once, in the constructor, and read with
+	 *          \c pread() into a buffer which is reused between samples. The
+	 *          result is a \c System::DiskUsage sized to the devices listed at
+	 *          construction; devices which are added later are ignored, and
+	 *          devices which are removed report zeroes.\n
+	 *          A sampler is not thread-safe: each thread should use its own.
+	 */
+	class DiskSampler {
+	public:
+		/**
+		 * \brief  Opens \c /proc/diskstats, and discovers the devices.
+		 * \param  procfs The root of the procfs tree to read from.
+		 * \throws std::system_error if \c /proc/diskstats could not be opened
+		 *         or read.
+		 */
+		explicit DiskSampler(const std::filesystem::path& procfs = "/proc");
+
+		/**
+		 * \brief Closes the file.
+		 */
+		~DiskSampler() noexcept;
+
+		/**
+		 * \brief Samplers own file descriptors, so they can't be copied.
+		 */
+		DiskSampler(const DiskSampler&) = delete;
+
+		/**
+		 * \brief Samplers own file descriptors, so they can't be copied.
+		 */
+		DiskSampler& operator=(const DiskSampler&) = delete;
+
+		/**
+		 * \brief   Takes a new sample and computes the rates since the previous
+		 *          one.
+		 * \details The first sample measures the rates since boot.
+		 * \return  The I/O rates. The reference stays valid until the next
+		 *          call.
+		 * \throws  std::system_error if \c /proc/diskstats could not be read.
+		 */
+		const System::DiskUsage& sample();
+
+		/**
+		 * \brief  Retrieves the last rates computed.
+		 * \return The last rates computed.
+		 */
+		const System::DiskUsage& last() const noexcept;
+	private:
+		/**
+		 * \brief  Reads \c /proc/diskstats into the buffer, and parses the
+		 *         counters of every known device into \c _current.
+		 * \throws std::system_error if the file could not be read.
+		 */
+		void _read();
+
+		/**
+		 * \brief The file descriptor of \c /proc/diskstats.
+		 */
+		int _fd = -1;
+
+		/**
+		 * \brief The buffer which \c /proc/diskstats is read into.
+		 */
+		std::vector<char> _buffer;
+
+		/**
+		 * \brief   The counters read by the previous sample, in rows of
+		 *          \c DISK_FIELDS.
+		 * \details Row \c i is device \c names[i].
+		 */
+		std::vector<std::uint64_t> _previous;
+
+		/**
+		 * \brief Scratch space for the counters of the current sample.
+		 */
+		std::vector<std::uint64_t> _current;
+
+		/**
+		 * \brief When the previous sample was taken, in seconds since boot.
+		 */
+		double _then = 0.0;
+
+		/**
+		 * \brief The last rates computed.
+		 */
+		System::DiskUsage _usage;
+	};
+#endif
+
+	/**
+	 * \brief Describes a network interface.
+	 */
+	struct NetworkInterface {
+		/**
+		 * \brief The name of the interface, e.g. \c "eth0" or \c "lo".
+		 */
+		std::string name;
+
+		/**
+		 * \brief The hardware address, e.g. \c "52:54:00:12:34:56", or an
+		 *        empty string if the interface doesn't have one.
+		 */
+		std::string mac;
+
+		/**
+		 * \brief The maximum transmission unit, in bytes.
+		 */
+		std::uint32_t mtu = 0;
+
+		/**
+		 * \brief The negotiated link speed, in megabits per second, or \c 0 if
+		 *        it is unknown (e.g. for virtual interfaces and down links).
+		 */
+		std::uint64_t speed = 0;
+
+		/**
+		 * \brief \c TRUE if the interface is administratively up.
+		 */
+		bool up = false;
+
+		/**
+		 * \brief \c TRUE if the interface is a loopback interface.
+		 */
+		bool loopback = false;
+
+		/**
+		 * \brief The NUMA node of the network adapter, or \c -1 if it is
+		 *        unknown or the interface is virtual.
+		 */
+		std::int32_t node = -1;
+
+		/**
+		 * \brief The IPv4 addresses, e.g. \c "192.168.1.10".
+		 */
+		std::vector<std::string> ipv4;
+
+		/**
+		 * \brief The IPv6 addresses, e.g. \c "fe80::5054:ff:fe12:3456".
+		 */
+		std::vector<std::string> ipv6;
+	};
+
+#ifdef __linux__
+	/**
+	 * \brief   Enumerates the network interfaces via sysfs and
+	 *          \c getifaddrs().
+	 * \details Every interface under \c <sysfs>/class/net is reported, in name
+	 *          order. A machine without a network still reports \c lo.
+	 * \param   sysfs     The root of the sysfs tree to read from.
+	 * \param   addresses \c TRUE to look up each interface's addresses with
+	 *                    \c getifaddrs(). This always queries the running
+	 *                    kernel, so it should be \c FALSE if \c sysfs isn't
+	 *                    the running kernel's.
+	 * \return  The interfaces.
+	 * \throws  std::system_error if the addresses could not be looked up.
+	 */
+	std::vector<System::NetworkInterface> enumerateNetworkInterfaces(
+		const std::filesystem::path& sysfs = "/sys",
+		const bool addresses = true);
+#endif
+
+	/**
+	 * \brief   Network traffic measured between two samples.
+	 * \details The figures are stored as a structure of arrays: element \c i of
+	 *          every vector describes the interface \c names[i].
+	 */
+	struct NetworkUsage {
+		/**
+		 * \brief  Finds an interface by its name.
+		 * \param  name The interface's name.
+		 * \return The interface's index, or \c -1 if it isn't listed.
+		 */
+		std::ptrdiff_t find(const std::string_view name) const noexcept;
+
+		/**
+		 * \brief The length of the sampling interval, in seconds.
+		 */
+		double interval = 0.0;
+
+		/**
+		 * \brief The name of each interface.
+		 */
+		std::vector<std::string> names;
+
+		/**
+		 * \brief The number of bytes each interface received per second.
+		 */
+		std::vector<double> rxBytes;
+
+		/**
+		 * \brief The number of bytes each interface transmitted per second.
+		 */
+		std::vector<double> txBytes;
+
+		/**
+		 * \brief The number of packets each interface received per second.
+		 */
+		std::vector<double> rxPackets;
+
+		/**
+		 * \brief The number of packets each interface transmitted per second.
+		 */
+		std::vector<double> txPackets;
+
+		/**
+		 * \brief The number of receive errors on each interface per second.
+		 */
+		std::vector<double> rxErrors;
+
+		/**
+		 * \brief The number of transmit errors on each interface per second.
+		 */
+		std::vector<double> txErrors;
+
+		/**
+		 * \brief The number of received packets each interface dropped per
+		 *        second.
+		 */
+		std::vector<double> rxDrops;
+
+		/**
+		 * \brief The number of packets to transmit each interface dropped per
+		 *        second.
+		 */
+		std::vector<double> txDrops;
+	};
+
+#ifdef __linux__
+	/**
+	 * \brief   Samples network traffic from \c /proc/net/dev without
+	 *          allocating.
+	 * \details The file is opened once, in the constructor, and read with
+	 *          \c pread() into a buffer which is reused between samples. The
+	 *          interfaces are discovered in the constructor: interfaces added
+	 *          later, e.g. by a container runtime, are not reported until a
+	 *          new sampler is created. The figures are those of the network
+	 *          namespace the constructor ran in.\n
+	 *          A sampler is not thread-safe: each thread should use its own.
+	 */
+	class NetworkSampler {
+	public:
+		/**
+		 * \brief  Opens \c /proc/net/dev, and discovers the interfaces.
+		 * \param  procfs The root of the procfs tree to read from.
+		 * \throws std::system_error if \c /proc/net/dev could not be opened or
+		 *         read.
+		 */
+		explicit NetworkSampler(const std::filesystem::path& procfs = "/proc");
+
+		/**
+		 * \brief Closes the file.
+		 */
+		~NetworkSampler() noexcept;
+
+		/**
+		 * \brief Samplers own file descriptors, so they can't be copied.
+		 */
+		NetworkSampler(const NetworkSampler&) = delete;
+
+		/**
+		 * \brief Samplers own file descriptors, so they can't be copied.
+		 */
+		NetworkSampler& operator=(const NetworkSampler&) = delete;
+
+		/**
+		 * \brief   Takes a new sample and computes the rates since the previous
+		 *          one.
+		 * \details The first sample measures the rates since the interfaces
+		 *          were created.
+		 * \return  The traffic rates. The reference stays valid until the next
+		 *          call.
+		 * \throws  std::system_error if \c /proc/net/dev could not be read.
+		 */
+		const System::NetworkUsage& sample();
+
+		/**
+		 * \brief  Retrieves the last rates computed.
+		 * \return The last rates computed.
+		 */
+		const System::NetworkUsage& last() const noexcept;
+	private:
+		/**
+		 * \brief  Reads \c /proc/net/dev into the buffer, and parses the
+		 *         counters of every known interface into \c _current.
+		 * \throws std::system_error if the file could not be read.
+		 */
+		void _read();
+
+		/**
+		 * \brief The file descriptor of \c /proc/net/dev.
+		 */
+		int _fd = -1;
+
+		/**
+		 * \brief The buffer which \c /proc/net/dev is read into.
+		 */
+		std::vector<char> _buffer;
+
+		/**
+		 * \brief   The counters read by the previous sample, in rows of
+		 *          \c NET_FIELDS.
+		 * \details Row \c i is interface \c names[i].
+		 */
+		std::vector<std::uint64_t> _previous;
+
+		/**
+		 * \brief Scratch space for the counters of the current sample.
+		 */
+		std::vector<std::uint64_t> _current;
+
+		/**
+		 * \brief When the previous sample was taken, in seconds since boot.
+		 */
+		double _then = 0.0;
+
+		/**
+		 * \brief The last rates computed.
+		 */
+		System::NetworkUsage _usage;
+	};
+#endif
+
+#ifdef __linux__
+	/**
+	 * \brief   The resources used by one process.
+	 * \details This has a fixed layout, with no heap-allocated members, so
+	 *          that batches of it can be sampled without allocating. Figures
+	 *          which could not be read, e.g. because another user's process
+	 *          hides them, are left at zero and \c complete is \c FALSE.
+	 */
+	struct ProcessStats {
+		/**
+		 * \brief The process ID.
+		 */
+		std::int32_t pid = 0;
+
+		/**
+		 * \brief The ID of the parent process.
+		 */
+		std::int32_t parent = 0;
+
+		/**
+		 * \brief The process name, truncated by the kernel to 15 characters.
+		 */
+		char name[16] = {};
+
+		/**
+		 * \brief The state, e.g. \c 'R' for running or \c 'S' for sleeping.
+		 */
+		char state = '?';
+
+		/**
+		 * \brief \c TRUE if every figure could be read.
+		 */
+		bool complete = true;
+
+		/**
+		 * \brief The number of threads.
+		 */
+		std::uint32_t threads = 0;
+
+		/**
+		 * \brief The number of open file descriptors.
+		 */
+		std::uint32_t fds = 0;
+
+		/**
+		 * \brief The size of the virtual address space, in bytes.
+		 */
+		std::uint64_t virtualSize = 0;
+
+		/**
+		 * \brief The resident set size, in bytes.
+		 */
+		std::uint64_t rss = 0;
+
+		/**
+		 * \brief   The proportional set size, in bytes.
+		 * \details Pages shared with other processes are divided between them,
+		 *          so this sums correctly across processes. It is read from
+		 *          \c smaps_rollup, unless the sampler was told to skip it.
+		 */
+		std::uint64_t pss = 0;
+
+		/**
+		 * \brief The part of the resident set backed by shared pages, in bytes.
+		 */
+		std::uint64_t shared = 0;
+
+		/**
+		 * \brief The peak resident set size, in bytes.
+		 */
+		std::uint64_t peakRSS = 0;
+
+		/**
+		 * \brief The amount swapped out, in bytes.
+		 */
+		std::uint64_t swap = 0;
+
+		/**
+		 * \brief The CPU time spent in user mode, in nanoseconds.
+		 */
+		std::uint64_t userTime = 0;
+
+		/**
+		 * \brief The CPU time spent in kernel mode, in nanoseconds.
+		 */
+		std::uint64_t systemTime = 0;
+
+		/**
+		 * \brief When the process started, in nanoseconds since boot.
+		 */
+		std::uint64_t startTime = 0;
+
+		/**
+		 * \brief The number of page faults which didn't need any I/O.
+		 */
+		std::uint64_t minorFaults = 0;
+
+		/**
+		 * \brief The number of page faults which needed I/O.
+		 */
+		std::uint64_t majorFaults = 0;
+
+		/**
+		 * \brief The number of times the process yielded the CPU.
+		 */
+		std::uint64_t voluntarySwitches = 0;
+
+		/**
+		 * \brief The number of times the process was preempted.
+		 */
+		std::uint64_t involuntarySwitches = 0;
+	};
+
+	/**
+	 * \brief   Samples the resources used by processes from \c /proc/<pid>.
+	 * \details Each sample reads \c stat, \c statm, \c status and, optionally,
+	 *          \c smaps_rollup into a buffer which is reused between samples,
+	 *          and counts the entries of \c fd, so sampling doesn't allocate.
+	 *          Paths are resolved relative to a descriptor of the procfs root
+	 *          which is opened once, in the constructor, and which is also
+	 *          reused to scan every PID.\n
+	 *          A sampler is not thread-safe: each thread should use its own.
+	 */
+	class ProcessSampler {
+	public:
+		/**
+		 * \brief  Opens the procfs root.
+		 * \param  procfs The root of the procfs tree to read from.
+		 * \param  rollup \c TRUE to read each process' PSS from
+		 *                \c smaps_rollup, which costs the kernel a walk of the
+		 *                process' page tables.
+		 * \throws std::system_error if \c procfs could not be opened.
+		 */
+		explicit ProcessSampler(const std::filesystem::path& procfs = "/proc",
+			const bool rollup = true);
+
+		/**
+		 * \brief Closes the procfs root.
+		 */
+		~ProcessSampler() noexcept;
+
+		/**
+		 * \brief Samplers own file descriptors, so they can't be copied.
+		 */
+		ProcessSampler(const ProcessSampler&) = delete;
+
+		/**
+		 * \brief Samplers own file descriptors, so they can't be copied.
+		 */
+		ProcessSampler& operator=(const ProcessSampler&) = delete;
+
+		/**
+		 * \brief  Samples one process.
+		 * \param  pid The process ID, or \c 0 for the calling process.
+		 * \param  out Receives the figures.
+		 * \return \c TRUE if the process was sampled, \c FALSE if it doesn't
+		 *         exist (any more).
+		 * \throws std::system_error if the process' \c stat file could not be
+		 *         read for any other reason.
+		 */
+		bool sample(const std::int32_t pid, System::ProcessStats& out);
+
+		/**
+		 * \brief   Samples every process.
+		 * \details Processes which exit during the scan are skipped. \c out is
+		 *          cleared first, and keeps its capacity between scans.
+		 * \param   out Receives the figures of each process, in PID order.
+		 * \return  The number of processes sampled.
+		 * \throws  std::system_error if the procfs root could not be listed.
+		 */
+		std::size_t scan(std::vector<System::ProcessStats>& out);
+	private:
+		/**
+		 * \brief  Samples the process whose directory is open.
+		 * \param  dir The descriptor of the process' directory.
+		 * \param  out Receives the figures.
+		 * \return \c TRUE if the process was sampled, \c FALSE if it exited.
+		 */
+		bool _sample(const int dir, System::ProcessStats& out);
+
+		/**
+		 * \brief  Reads a file of a process' directory into the buffer.
+		 * \param  dir  The descriptor of the process' directory.
+		 * \param  name The name of the file.
+		 * \return View of the file's contents, or an empty view whose \c data()
+		 *         is \c nullptr if it could not be read, in which case \c errno
+		 *         says why.
+		 */
+		std::string_view _read(const int dir, const char* name) noexcept;
+
+		/**
+		 * \brief  Counts the entries of a process' \c fd directory.
+		 * \param  dir The descriptor of the process' directory.
+		 * \return The number of open file descriptors, or \c -1 if they could
+		 *         not be listed.
+		 */
+		long _countFDs(const int dir) noexcept;
+
+		/**
+		 * \brief The descriptor of the procfs root.
+		 */
+		int _procFd = -1;
+
+		/**
+		 * \brief \c TRUE to read \c smaps_rollup.
+		 */
+		bool _rollup = true;
+
+		/**
+		 * \brief The length of a clock tick, in nanoseconds.
+		 */
+		std::uint64_t _tick = 10000000;
+
+		/**
+		 * \brief The size of a page, in bytes.
+		 */
+		std::uint64_t _pageSize = 4096;
+
+		/**
+		 * \brief The buffer which files are read into.
+		 */
+		std::vector<char> _buffer;
+
+		/**
+		 * \brief The buffer which directory entries are listed into.
+		 */
+		std::vector<char> _entries;
+	};
+#endif
+
+#ifdef __linux__
+	/**
+	 * \brief The bandwidth limits a cgroup places on one block device.
+	 */
+	struct IOLimit {
+		/**
+		 * \brief The device's major number.
+		 */
+		std::uint32_t major = 0;
+
+		/**
+		 * \brief The device's minor number.
+		 */
+		std::uint32_t minor = 0;
+
+		/**
+		 * \brief The maximum bytes read per second.
+		 */
+		std::uint64_t readBytes = UINT64_MAX;
+
+		/**
+		 * \brief The maximum bytes written per second.
+		 */
+		std::uint64_t writeBytes = UINT64_MAX;
+
+		/**
+		 * \brief The maximum read operations per second.
+		 */
+		std::uint64_t reads = UINT64_MAX;
+
+		/**
+		 * \brief The maximum write operations per second.
+		 */
+		std::uint64_t writes = UINT64_MAX;
+	};
+
+	/**
+	 * \brief   The resource limits of the calling process' cgroup v2 hierarchy.
+	 * \details Each limit is the tightest one set by the process' cgroup or
+	 *          any of its ancestors, so it is the limit which actually applies.
+	 *          A limit of \c UNLIMITED means that none of them set one.
+	 */
+	struct CgroupLimits {
+		/**
+		 * \brief The value of a limit which has not been set.
+		 */
+		static constexpr std::uint64_t UNLIMITED = UINT64_MAX;
+
+		/**
+		 * \brief The process' cgroup, e.g. \c "/kubepods/pod1/abc", or an
+		 *        empty string if there is no cgroup v2 hierarchy mounted.
+		 */
+		std::string path;
+
+		/**
+		 * \brief The directory of the process' cgroup, which holds its
+		 *        interface files, or an empty path if there is none.
+		 */
+		std::filesystem::path directory;
+
+		/**
+		 * \brief   The CPU time the cgroup may use per period, in CPUs (from
+		 *          \c cpu.max).
+		 * \details E.g. \c 1.5 for a quota of 150ms every 100ms, or \c 0.0 if
+		 *          there is no quota.
+		 */
+		double cpuQuota = 0.0;
+
+		/**
+		 * \brief The CPUs the cgroup may run on (from
+		 *        \c cpuset.cpus.effective), or an empty list if the cpuset
+		 *        controller isn't enabled.
+		 */
+		std::vector<std::uint32_t> cpus;
+
+		/**
+		 * \brief The memory the cgroup may use, in bytes (from \c memory.max).
+		 */
+		std::uint64_t memoryMax = UNLIMITED;
+
+		/**
+		 * \brief The memory the cgroup is using, in bytes (from
+		 *        \c memory.current).
+		 */
+		std::uint64_t memoryCurrent = 0;
+
+		/**
+		 * \brief The percentage of the last 10 seconds in which some of the
+		 *        cgroup's tasks were stalled on memory (from
+		 *        \c memory.pressure).
+		 */
+		double memoryPressure = 0.0;
+
+		/**
+		 * \brief The bandwidth limits of each device (from \c io.max).
+		 */
+		std::vector<System::IOLimit> io;
+
+		/**
+		 * \brief   Reads the limits of the calling process' cgroup.
+		 * \details The cgroup is found in \c <procfs>/self/cgroup, and the
+		 *          cgroup v2 hierarchy in \c <procfs>/self/mountinfo. Missing
+		 *          files, e.g. of controllers which aren't enabled, are
+		 *          treated as setting no limit.
+		 * \param   procfs The root of the procfs tree to read from.
+		 * \param   root   The directory which mount points are relative to.
+		 * \return  The limits. If there is no cgroup v2 hierarchy, \c path is
+		 *          empty and nothing is limited.
+		 * \throws  std::system_error if \c <procfs>/self/mountinfo could not be
+		 *          read.
+		 */
+		static System::CgroupLimits load(
+			const std::filesystem::path& procfs = "/proc",
+			const std::filesystem::path& root = "/");
+	};
+#endif
+
+#ifdef __linux__
+	/**
+	 * \brief The stall figures of one line of a Pressure Stall Information
+	 *        file.
+	 */
+	struct PressureStall {
+		/**
+		 * \brief The percentage of the last 10 seconds which was stalled.
+		 */
+		double avg10 = 0.0;
+
+		/**
+		 * \brief The percentage of the last 60 seconds which was stalled.
+		 */
+		double avg60 = 0.0;
+
+		/**
+		 * \brief The percentage of the last 300 seconds which was stalled.
+		 */
+		double avg300 = 0.0;
+
+		/**
+		 * \brief The total time stalled, in microseconds.
+		 */
+		std::uint64_t total = 0;
+	};
+
+	/**
+	 * \brief   The Pressure Stall Information of one resource, e.g. of
+	 *          \c /proc/pressure/memory or of a cgroup's \c memory.pressure.
+	 */
+	struct PressureStats {
+		/**
+		 * \brief When at least one task was stalled on the resource.
+		 */
+		System::PressureStall some;
+
+		/**
+		 * \brief   When every non-idle task was stalled on the resource.
+		 * \details The kernel reports this as all zeroes for the CPU of the
+		 *          whole system.
+		 */
+		System::PressureStall full;
+
+		/**
+		 * \brief   Parses the contents of a PSI file.
+		 * \details This does not allocate.
+		 * \param   text  The contents of the file.
+		 * \param   stats The structure to store the figures in. Every field is
+		 *                reset before the text is parsed.
+		 * \return  \c TRUE if the text contained a \c some line.
+		 */
+		static bool parse(const std::string_view text,
+			System::PressureStats& stats) noexcept;
+	};
+
+	/**
+	 * \brief The resources which Pressure Stall Information is tracked for.
+	 */
+	enum class PressureResource {
+		CPU,
+		Memory,
+		IO
+	};
+
+	/**
+	 * \brief The Pressure Stall Information of every resource.
+	 */
+	struct PressureSnapshot {
+		/**
+		 * \brief The pressure on the CPU.
+		 */
+		System::PressureStats cpu;
+
+		/**
+		 * \brief The pressure on memory.
+		 */
+		System::PressureStats memory;
+
+		/**
+		 * \brief The pressure on block I/O.
+		 */
+		System::PressureStats io;
+
+		/**
+		 * \brief  Selects the pressure on one resource.
+		 * \param  resource The resource.
+		 * \return The resource's figures.
+		 */
+		const System::PressureStats& operator[](
+			const System::PressureResource resource) const noexcept;
+	};
+
+	/**
+	 * \brief   Waits for stalls to exceed a budget, using the kernel's PSI
+	 *          triggers.
+	 * \details Each trigger is a PSI file which has been opened and given a
+	 *          threshold, e.g. "150ms of memory stalls within any 1s". The
+	 *          kernel then wakes \c wait() when the threshold is exceeded, so
+	 *          the process doesn't need to poll the figures. The kernel limits
+	 *          the window to between 500ms and 10s, and unprivileged processes
+	 *          to multiples of 2s.\n
+	 *          A monitor is not thread-safe, except for \c wake(), which may be
+	 *          called from any thread to interrupt a \c wait().
+	 */
+	class PressureMonitor {
+	public:
+		/**
+		 * \brief  Creates a monitor with no triggers.
+		 * \param  procfs The root of the procfs tree whose \c pressure
+		 *                directory \c watch() opens.
+		 * \throws std::system_error if the wake-up event could not be created.
+		 */
+		explicit PressureMonitor(const std::filesystem::path& procfs = "/proc");
+
+		/**
+		 * \brief Closes every trigger.
+		 */
+		~PressureMonitor() noexcept;
+
+		/**
+		 * \brief Monitors own file descriptors, so they can't be copied.
+		 */
+		PressureMonitor(const PressureMonitor&) = delete;
+
+		/**
+		 * \brief Monitors own file descriptors, so they can't be copied.
+		 */
+		PressureMonitor& operator=(const PressureMonitor&) = delete;
+
+		/**
+		 * \brief  Adds a trigger on the pressure of the whole system.
+		 * \param  resource The resource to watch.
+		 * \param  full     \c TRUE to count stalls of every task at once,
+		 *                  \c FALSE to count stalls of any task.
+		 * \param  stall    The stall time which fires the trigger.
+		 * \param  window   The window the stall time is measured over.
+		 * \return The index of the trigger.
+		 * \throws std::system_error if the trigger could not be created, e.g.
+		 *         because PSI is disabled or the window is out of range.
+		 */
+		std::size_t watch(const System::PressureResource resource,
+			const bool full, const std::chrono::microseconds stall,
+			const std::chrono::microseconds window);
+
+		/**
+		 * \brief  Adds a trigger on the pressure recorded in a PSI file.
+		 * \param  file   The PSI file, e.g. the \c memory.pressure file of
+		 *                \c System::CgroupLimits::directory.
+		 * \param  full   \c TRUE to count stalls of every task at once,
+		 *                \c FALSE to count stalls of any task.
+		 * \param  stall  The stall time which fires the trigger.
+		 * \param  window The window the stall time is measured over.
+		 * \return The index of the trigger.
+		 * \throws std::system_error if the trigger could not be created.
+		 */
+		std::size_t watch(const std::filesystem::path& file, const bool full,
+			const std::chrono::microseconds stall,
+			const std::chrono::microseconds window);
+
+		/**
+		 * \brief   Waits for triggers to fire.
+		 * \details This does not allocate once \c fired has grown to the
+		 *          number of triggers.
+		 * \param   timeout How long to wait, or a negative duration to wait
+		 *                  until a trigger fires or \c wake() is called.
+		 * \param   fired   Receives the indices of the triggers which fired.
+		 * \return  \c TRUE if any trigger fired, \c FALSE if the wait timed out
+		 *          or was woken.
+		 * \throws  std::system_error if the wait failed, or a trigger was
+		 *          destroyed by the kernel (e.g. its cgroup was removed).
+		 */
+		bool wait(const std::chrono::milliseconds timeout,
+			std::vector<std::size_t>& fired);
+
+		/**
+		 * \brief Interrupts the current or next \c wait().
+		 */
+		void wake() noexcept;
+
+		/**
+		 * \brief  Retrieves the number of triggers.
+		 * \return The number of triggers.
+		 */
+		std::size_t size() const noexcept;
+	private:
+		/**
+		 * \brief The root of the procfs tree.
+		 */
+		std::filesystem::path _procfs;
+
+		/**
+		 * \brief   The descriptors to poll.
+		 * \details The first is the wake-up event, and the rest are the
+		 *          triggers, in the order they were added.
+		 */
+		std::vector<struct pollfd> _fds;
+	};
+#endif
+
+#ifdef __linux__
+	/**
+	 * \brief   Identifies the running kernel and the distribution.
+	 * \details The kernel fields come from a single \c uname() call, and the
+	 *          distribution fields from \c /etc/os-release. Fields which the
+	 *          distribution doesn't report are left empty.
+	 */
+	struct OSIdentity {
+		/**
+		 * \brief The kernel's name, e.g. \c "Linux".
+		 */
+		std::string sysname;
+
+		/**
+		 * \brief The kernel's release, e.g. \c "6.1.0-18-amd64".
+		 */
+		std::string release;
+
+		/**
+		 * \brief The kernel's build version, e.g.
+		 *        \c "#1 SMP PREEMPT_DYNAMIC Debian 6.1.76-1 (2024-02-01)".
+		 */
+		std::string version;
+
+		/**
+		 * \brief The machine's hardware name, e.g. \c "x86_64".
+		 */
+		std::string machine;
+
+		/**
+		 * \brief The kernel's major version, e.g. \c 6 for \c "6.1.0".
+		 */
+		std::uint32_t kernelMajor = 0;
+
+		/**
+		 * \brief The kernel's minor version, e.g. \c 1 for \c "6.1.0".
+		 */
+		std::uint32_t kernelMinor = 0;
+
+		/**
+		 * \brief The kernel's patch level, e.g. \c 0 for \c "6.1.0".
+		 */
+		std::uint32_t kernelPatch = 0;
+
+		/**
+		 * \brief The distribution's name (\c NAME), e.g. \c "Debian GNU/Linux".
+		 */
+		std::string name;
+
+		/**
+		 * \brief The distribution's identifier (\c ID), e.g. \c "debian".
+		 */
+		std::string id;
+
+		/**
+		 * \brief The distribution's version (\c VERSION_ID), e.g. \c "12".
+		 */
+		std::string versionID;
+
+		/**
+		 * \brief The identifiers of the distributions this one derives from
+		 *        (\c ID_LIKE), separated by spaces, e.g. \c "rhel fedora".
+		 */
+		std::string idLike;
+
+		/**
+		 * \brief The distribution's full name (\c PRETTY_NAME), e.g.
+		 *        \c "Debian GNU/Linux 12 (bookworm)".
+		 */
+		std::string prettyName;
+
+		/**
+		 * \brief  Checks if the kernel is at least a given version.
+		 * \param  major The major version, e.g. \c 5 for io_uring.
+		 * \param  minor The minor version, e.g. \c 6 for io_uring.
+		 * \param  patch The patch level.
+		 * \return \c TRUE if the kernel is that version or later.
+		 */
+		bool kernelAtLeast(const std::uint32_t major, const std::uint32_t minor,
+			const std::uint32_t patch = 0) const noexcept;
+
+		/**
+		 * \brief   Parses the contents of an \c os-release file.
+		 * \details Quoted values are unquoted and unescaped. Unknown keys are
+		 *          ignored, and the kernel fields are left untouched.
+		 * \param   text     The contents of the file.
+		 * \param   identity The structure to store the distribution fields in.
+		 */
+		static void parseOSRelease(const std::string_view text,
+			System::OSIdentity& identity);
+	};
+#endif
+
+	/**
+	 * \brief   The results of one WMI query: one row per instance of the class,
+	 *          and one column per selected property.
+	 * \details Every value is stored as a UTF-8 string, row by row, in one
+	 *          contiguous array. Numbers are stored in decimal, and \c NULL
+	 *          values as empty strings. Property names are compared without
+	 *          regard to case, as WMI does.
+	 */
+	class WMITable {
+	public:
+		/**
+		 * \brief Constructs an empty table with no columns.
+		 */
+		WMITable() = default;
+
+		/**
+		 * \brief Constructs an empty table.
+		 * \param columns The names of the properties selected.
+		 */
+		explicit WMITable(std::vector<std::string> columns) noexcept;
+
+		/**
+		 * \brief  Retrieves the names of the properties selected.
+		 * \return The column names, in the order they were selected.
+		 */
+		const std::vector<std::string>& columns() const noexcept;
+
+		/**
+		 * \brief  Retrieves the number of instances in the table.
+		 * \return The number of rows.
+		 */
+		std::size_t rows() const noexcept;
+
+		/**
+		 * \brief  Finds the column of a property.
+		 * \param  property The name of the property.
+		 * \return The index of the column, or \c -1 if the property wasn't
+		 *         selected.
+		 */
+		std::ptrdiff_t column(const std::string_view property) const noexcept;
+
+		/**
+		 * \brief  Retrieves a value.
+		 * \param  row    The index of the instance.
+		 * \param  column The index of the column.
+		 * \return The value.
+		 * \throws std::out_of_range if \c row or \c column is out of range.
+		 */
+		const std::string& at(const std::size_t row, const std::size_t column)
+			const;
+
+		/**
+		 * \brief  Finds a value by the name of its property.
+		 * \param  row      The index of the instance.
+		 * \param  property The name of the property.
+		 * \return Pointer to the value, or \c nullptr if \c row is out of range
+		 *         or the property wasn't selected.
+		 */
+		const std::string* find(const std::size_t row,
+			const std::string_view property) const noexcept;
+
+		/**
+		 * \brief   Appends an instance whose values are all empty.
+		 * \details This is used by \c System::WMIBackend implementations to
+		 *          fill the table in.
+		 * \return  Pointer to the first value of the new row. It is invalidated
+		 *          by the next call to this method.
+		 */
+		std::string* addRow();
+	private:
+		/**
+		 * \brief The names of the properties selected.
+		 */
+		std::vector<std::string> _columns;
+
+		/**
+		 * \brief The values, row by row.
+		 */
+		std::vector<std::string> _values;
+	};
+
+	/**
+	 * \brief   Executes WQL queries on behalf of \c System::WMIClient.
+	 * \details On Windows, \c System::Properties connects one of these to
+	 *          \c ROOT\\CIMV2 through \c IWbemServices. Other implementations
+	 *          can serve canned tables, so that code built on
+	 *          \c System::WMIClient can be exercised and benchmarked on any
+	 *          platform.
+	 */
+	class WMIBackend {
+	public:
+		/**
+		 * \brief Destroys the backend.
+		 */
+		virtual ~WMIBackend() noexcept = default;
+
+		/**
+		 * \brief   Executes a query and retrieves every instance it returns.
+		 * \details This may be called from multiple threads, but never
+		 *          concurrently by the same \c System::WMIClient.
+		 * \param   className The name of the class being queried.
+		 * \param   query     The full query, e.g.
+		 *                    <tt>SELECT Name, DriverVersion FROM
+		 *                    Win32_VideoController</tt>.
+		 * \param   out       A table whose columns are the properties
+		 *                    selected by \c query, in the same order. It
+		 *                    receives one row per instance.
+		 * \throws  std::system_error if the query failed.
+		 */
+		virtual void execQuery(const std::string& className,
+			const std::string& query, System::WMITable& out) = 0;
+	};
+
+	/**
+	 * \brief   Retrieves WMI classes in as few round trips as possible.
+	 * \details Each class is queried once for every property asked of it so
+	 *          far, and the resulting table is cached until it is invalidated.
+	 *          Asking for a property which hasn't been fetched yet queries the
+	 *          class again, for the union of the properties, so callers which
+	 *          share a class should ask for all of their properties up front.
+	 *          The client may be used from multiple threads at once.
+	 */
+	class WMIClient {
+	public:
+		/**
+		 * \brief Constructs a client.
+		 * \param backend The backend which executes the queries.
+		 */
+		explicit WMIClient(std::shared_ptr<System::WMIBackend> backend)
+			noexcept;
+
+		/**
+		 * \brief  Retrieves properties of every instance of a class.
+		 * \param  className  The name of the class, e.g.
+		 *                    \c "Win32_VideoController".
+		 * \param  properties The properties to retrieve. The table may hold
+		 *                    more, if they were asked for earlier.
+		 * \return The table, which stays valid even if the class is queried
+		 *         again.
+		 * \throws std::system_error if the query failed. Failures aren't
+		 *         cached.
+		 */
+		std::shared_ptr<const System::WMITable> select(
+			const std::string_view className,
+			const std::initializer_list<std::string_view> properties);
+
+		/**
+		 * \brief Drops the cached table of a class.
+		 * \param className The name of the class.
+		 */
+		void invalidate(const std::string_view className) noexcept;
+
+		/**
+		 * \brief Drops every cached table.
+		 */
+		void invalidate() noexcept;
+
+		/**
+		 * \brief  Retrieves the number of queries executed so far.
+		 * \return The number of calls made to
+		 *         \c System::WMIBackend::execQuery().
+		 */
+		std::uint64_t queries() const noexcept;
+	private:
+		/**
+		 * \brief The backend which executes the queries.
+		 */
+		std::shared_ptr<System::WMIBackend> _backend;
+
+		/**
+		 * \brief   The cached tables, with the names of their classes.
+		 * \details A process only reads a handful of classes, so they are
+		 *          searched linearly, which spares building a key per lookup.
+		 */
+		std::vector<std::pair<std::string,
+			std::shared_ptr<const System::WMITable>>> _tables;
+
+		/**
+		 * \brief   Guards \c _tables.
+		 * \details This is held during queries, so that concurrent callers
+		 *          wait for one query instead of each running their own.
+		 */
+		std::mutex _mutex;
+
+		/**
+		 * \brief The number of queries executed so far.
+		 */
+		std::atomic<std::uint64_t> _queries{ 0 };
+	};
+
+	/**
+	 * \brief   The filesystem trees which \c System::Properties reads from.
+	 * \details By default, every probe reads the live system. The trees can be
+	 *          pointed elsewhere to read the host's \c /proc and \c /sys from
+	 *          inside a container, or to replay a captured machine.\n
+	 *          When any tree isn't the live one, the probes which would
+	 *          otherwise make system calls about the running kernel read
+	 *          \c proc instead: \c uname() is replaced by
+	 *          \c proc/sys/kernel, and \c sysinfo() by \c proc/meminfo. Only
+	 *          the machine architecture, which procfs doesn't report, is still
+	 *          read from \c uname().\n
+	 *          On Windows, only \c root is used.
+	 */
+	struct Roots {
+		/**
+		 * \brief   Creates roots which all live under one directory.
+		 * \param   prefix The directory, which contains \c proc and \c sys.
+		 * \return  The roots.
+		 */
+		static System::Roots under(const std::filesystem::path& prefix);
+
+		/**
+		 * \brief  Checks if every tree is the live system's.
+		 * \return \c TRUE if every tree is at its default location.
+		 */
+		bool live() const noexcept;
+
+		/**
+		 * \brief   Retrieves the mount table the mount queries read.
+		 * \details On the live system, this is \c /proc/self/mountinfo. In
+		 *          any other tree, \c self would still be this process, so the
+		 *          mount namespace of PID 1, i.e. of the host's init, is read
+		 *          instead: \c <proc>/1/mountinfo.
+		 * \return  The path of the \c mountinfo file.
+		 */
+		std::filesystem::path mountinfo() const;
+
+		/**
+		 * \brief The root filesystem, which storage is measured on, mount
+		 *        points are resolved against, and \c pci.ids is looked up in.
+		 */
+		std::filesystem::path root = "/";
+
+		/**
+		 * \brief The procfs tree.
+		 */
+		std::filesystem::path proc = "/proc";
+
+		/**
+		 * \brief The sysfs tree.
+		 */
+		std::filesystem::path sys = "/sys";
+	};
+
+	/**
+	 * \brief   A value holding every property which \c System::Properties can
+	 *          retrieve.
+	 * \details Each property is either present, or absent because its probe
+	 *          failed. Sizes are stored in bytes, without any unit notation.\n
+	 *          \c System::Snapshot owns its strings, and is what
+	 *          \c System::Properties::snapshot() returns.
+	 *          \c System::SnapshotView views strings stored elsewhere, and is
+	 *          what \c System::decodeSnapshot() returns, without copying them
+	 *          out of the encoded buffer.\n
+	 *          The binary encoding of a snapshot is:
+	 *          - The two magic bytes \c "SP".
+	 *          - A version byte, currently \c 1.
+	 *          - The length of the body, as a LEB128 varint.
+	 *          - The body: a varint bitmask of the properties present, indexed
+	 *            by \c System::Property, followed by each present property in
+	 *            \c System::Property order. Strings are stored as a varint
+	 *            length followed by their bytes, and sizes as varints.
+	 *
+	 *          Later versions only append properties, so decoders skip the
+	 *          properties they don't know using the body's length.
+	 * \tparam  String The type of the string properties: \c std::string or
+	 *                 \c std::string_view.
+	 */
+	template<typename String>
+	struct BasicSnapshot {
+		/**
+		 * \brief The version of the binary encoding written by \c encode().
+		 */
+		static constexpr std::uint8_t VERSION = 1;
+
+		/**
+		 * \brief Creates a snapshot with every property absent.
+		 */
+		BasicSnapshot() = default;
+
+		/**
+		 * \brief Copies a snapshot with a different string type, e.g. to take
+		 *        ownership of a \c System::SnapshotView's strings.
+		 * \param other The snapshot to copy.
+		 */
+		template<typename Other>
+		explicit BasicSnapshot(const BasicSnapshot<Other>& other) :
+			present(other.present), CPUModel(other.CPUModel),
+			CPUArchitecture(other.CPUArchitecture), RAMTotal(other.RAMTotal),
+			OSName(other.OSName), OSVersion(other.OSVersion),
+			GPUVendor(other.GPUVendor), GPUName(other.GPUName),
+			GPUDriver(other.GPUDriver), StorageTotal(other.StorageTotal),
+			StorageFree(other.StorageFree) {}
+
+		/**
+		 * \brief  Checks if a property is present.
+		 * \param  property The property to check.
+		 * \return \c TRUE if the property was retrieved successfully.
+		 */
+		bool has(const System::Property property) const noexcept;
+
+		/**
+		 * \brief Marks a property as present.
+		 * \param property The property to mark.
+		 */
+		void set(const System::Property property) noexcept;
+
+		/**
+		 * \brief   Appends the binary encoding of this snapshot to a buffer.
+		 * \details Encoding a batch into one buffer only allocates when the
+		 *          buffer grows.
+		 * \param   out The buffer to append to.
+		 */
+		void encode(std::string& out) const;
+
+		/**
+		 * \brief   Formats this snapshot as a JSON object, for debugging.
+		 * \details Absent properties are left out.
+		 * \return The JSON object, on one line.
+		 */
+		std::string json() const;
+
+		/**
+		 * \brief   Compares this snapshot with another, property by property.
+		 * \details A property which is present in one snapshot but not the
+		 *          other is reported as different.
+		 * \param   other The snapshot to compare with.
+		 * \return  The properties which differ, in \c System::Property order.
+		 */
+		std::vector<System::Property> diff(const BasicSnapshot& other) const;
+
+		/**
+		 * \brief Bitmask of the properties present, indexed by
+		 *        \c System::Property.
+		 */
+		std::uint32_t present = 0;
+
+		/**
+		 * \brief The CPU model name.
+		 */
+		String CPUModel;
+
+		/**
+		 * \brief The CPU architecture.
+		 */
+		String CPUArchitecture;
+
+		/**
+		 * \brief The total RAM, in bytes.
+		 */
+		std::uint64_t RAMTotal = 0;
+
+		/**
+		 * \brief The OS name.
+		 */
+		String OSName;
+
+		/**
+		 * \brief The OS version.
+		 */
+		String OSVersion;
+
+		/**
+		 * \brief The GPU vendor.
+		 */
+		String GPUVendor;
+
+		/**
+		 * \brief The GPU name.
+		 */
+		String GPUName;
+
+		/**
+		 * \brief The GPU driver version.
+		 */
+		String GPUDriver;
+
+		/**
+		 * \brief The capacity of the drive, in bytes.
+		 */
+		std::uint64_t StorageTotal = 0;
+
+		/**
+		 * \brief The free space on the drive, in bytes.
+		 */
+		std::uint64_t StorageFree = 0;
+	};
+
+	/**
+	 * \brief A snapshot which owns its strings.
+	 */
+	typedef System::BasicSnapshot<std::string> Snapshot;
+
+	/**
+	 * \brief A snapshot which views strings stored elsewhere.
+	 */
+	typedef System::BasicSnapshot<std::string_view> SnapshotView;
+
+	/**
+	 * \brief   Decodes one snapshot from the start of a buffer, without copying
+	 *          its strings.
+	 * \details To decode a batch, call this repeatedly, advancing the buffer
+	 *          by the number of bytes consumed each time.
+	 * \param   data The buffer. It must outlive \c out.
+	 * \param   out  Receives the snapshot, whose strings view \c data.
+	 * \return  The number of bytes consumed, or \c 0 if the buffer doesn't
+	 *          start with a valid snapshot, in which case \c out is
+	 *          unspecified.
+	 */
+	std::size_t decodeSnapshot(const std::string_view data,
+		System::SnapshotView& out) noexcept;
+
+	/**
+	 * \brief   This class lets the client query the computer for hardware and
+	 *          software information.
+	 * \details Constructing an object is cheap: each subsystem is only
+	 *          initialised when an accessor first needs it. Most programs
+	 *          should share \c Properties::global() rather than construct
+	 *          their own.
+	 * \warning Within the Windows implementation, this library makes use of the
+	 *          COM library. The first accessor which reads WMI starts a thread
+	 *          owned by this object, which calls \c CoInitializeEx() to join
+	 *          the multithreaded apartment, and then \c CoInitializeSecurity(),
+	 *          \c CoCreateInstance(), \c IWbemLocator::ConnectServer(), and
+	 *          \c CoSetProxyBlanket(). Every WMI query is made on that thread,
+	 *          so the accessors can be called from any thread, in any
+	 *          apartment, and the calling threads don't need to initialise COM.
+	 *          Callers wait for the thread without pumping messages. If your
+	 *          program has already set the process' COM security levels, they
+	 *          are kept.
+	 * \remarks Every property is cached per instance, according to its
+	 *          \c System::CachePolicy, and the accessors may be called from
+	 *          multiple threads at once. Concurrent callers of the same accessor
+	 *          wait for a single probe instead of each running their own.
+	 */
+	class Properties {
+	public:
+		/**
+		 * \brief   Creates an object which reads the computer.
+		 * \details Nothing is probed or connected to until an accessor needs
+		 *          it, so failures are reported by the accessors.
+		 * \param   roots The filesystem trees to read from. By default, the
+		 *                live system is read.
+		 */
+		explicit Properties(const System::Roots& roots = System::Roots());
+
+		/**
+		 * \brief   Retrieves the process-wide object, which reads the live
+		 *          system.
+		 * \details It is created on first use, and is never destroyed, so that
+		 *          it can still be used by other static objects' destructors.
+		 *          Its caches are shared by every caller.
+		 * \return  The object.
+		 */
+		static System::Properties& global();
+
+		/**
+		 * \brief Safely destroys the connection between the program and the
+		 *        computer.
+		 */
+		~Properties() noexcept;
+
+		/**
+		 * \brief  Retrieves the filesystem trees this object reads from.
+		 * \return The roots given to the constructor.
+		 */
+		const System::Roots& roots() const noexcept;
+
+		/**
+		 * \brief   Retrieves every property at once.
+		 * \details The properties are probed concurrently, as with
+		 *          \c prefetchAll(), and then read from the cache. Properties
+		 *          which failed are left absent instead of throwing.
+		 * \return  The snapshot.
+		 */
+		System::Snapshot snapshot();
+
+		/**
+		 * \brief  Retrieves the CPU model name.
+		 * \return User-friendly name of the CPU.
+		 * \throws std::system_error if the the request failed. An OS-specific
+		 *         code and error string will be generated.
+		 */
+		std::string CPUModel();
+
+		/**
+		 * \brief  Retrieves the CPU architecture.
+		 * \return Architecture of the CPU.
+		 * \throws std::system_error if the the request failed. An OS-specific
+		 *         code and error string will be generated.
+		 */
+		std::string CPUArchitecture();
+
+		/**
+		 * \brief   Retrieves the instruction set extensions the CPU supports.
+		 * \details These are detected with \c CPUID or \c getauxval() rather
+		 *          than read from \c /proc, so they always describe the running
+		 *          machine, even if the object reads another tree. This is the
+		 *          same as \c System::cpuFeatures(), which can be used without
+		 *          a \c System::Properties object.
+		 * \return  The supported features.
+		 */
+		System::CPUFeatures CPUCapabilities() const noexcept;
+
+#ifdef __linux__
+		/**
+		 * \brief   Retrieves the parsed \c /proc/cpuinfo snapshot.
+		 * \details The snapshot is built on first use and then reused by every
+		 *          CPU accessor, until \c refreshCPUSnapshot() is called. The
+		 *          returned snapshot stays valid even if it is replaced.
+		 * \return  The CPU snapshot.
+		 * \throws  std::system_error if \c /proc/cpuinfo could not be read.
+		 */
+		std::shared_ptr<const System::CPUInfo> CPUSnapshot();
+
+		/**
+		 * \brief  Re-reads \c /proc/cpuinfo, replacing the current snapshot, and
+		 *         drops the cached CPU properties.
+		 * \throws std::system_error if \c /proc/cpuinfo could not be read. The
+		 *         previous snapshot is kept if this happens.
+		 */
+		void refreshCPUSnapshot();
+
+		/**
+		 * \brief   Measures CPU utilisation since the previous call.
+		 * \details The first call measures utilisation since boot. This property
+		 *          is cached with \c System::CachePolicy::Volatile, so the
+		 *          measuring interval is at least the volatile lifetime. To sample
+		 *          at a specific rate, use a dedicated \c System::CPUSampler.
+		 * \return  The CPU utilisation.
+		 * \throws  std::system_error if \c /proc/stat could not be read.
+		 */
+		System::CPUUsage CPULoad();
+
+		/**
+		 * \brief   Retrieves the machine's CPU topology.
+		 * \details The topology is built once, and is cached with
+		 *          \c System::CachePolicy::Static.
+		 * \return  The CPU topology.
+		 * \throws  std::system_error if the topology could not be read.
+		 */
+		std::shared_ptr<const System::Topology> CPUTopology();
+#endif
+
+		/**
+		 * \brief   Retrieves the total installed RAM available.
+		 * \details On the Windows implementation, the total RAM installed will be
+		 *          returned.\n
+		 *          On the Linux implementation, only the RAM available for use at
+		 *          the time of calling will be returned. This could mean that 16GB
+		 *          of RAM is installed, for example, but only 8GB of it is readily
+		 *          available.
+		 * \param   unit The unit of memory to return the total RAM in. By default,
+		 *               it is \c System::Unit::GB.
+		 * \return  The total RAM installed.
+		 * \throws  std::system_error if the the request failed. An OS-specific
+		 *          code and error string will be generated.
+		 */
+		std::string RAMTotal(const System::Unit unit = System::Unit::GB);
+
+		/**
+		 * \brief   Retrieves the total installed RAM available, in bytes.
+		 * \details This performs no allocations once the value is cached.
+		 * \return  The total RAM installed, in bytes.
+		 * \throws  std::system_error if the the request failed. An OS-specific
+		 *          code and error string will be generated.
+		 * \sa      \c RAMTotal()
+		 */
+		std::uint64_t RAMTotalBytes();
+
+#ifdef __linux__
+		/**
+		 * \brief   Retrieves a breakdown of the machine's memory from
+		 *          \c /proc/meminfo.
+		 * \details This property is cached with
+		 *          \c System::CachePolicy::Volatile. To poll memory at a high
+		 *          frequency, use a dedicated \c System::MemorySampler instead.
+		 * \return  The memory figures.
+		 * \throws  std::system_error if \c /proc/meminfo could not be read.
+		 */
+		System::MemoryStats RAMStats();
+
+		/**
+		 * \brief   Retrieves the resources used by a process.
+		 * \details This is not cached. To sample processes at a high frequency,
+		 *          or to scan every process, use a dedicated
+		 *          \c System::ProcessSampler instead.
+		 * \param   pid The process ID. By default, the calling process is
+		 *              sampled.
+		 * \return  The process' figures.
+		 * \throws  std::system_error if the process doesn't exist, or could not
+		 *          be read.
+		 */
+		System::ProcessStats process(const std::int32_t pid = 0);
+
+		/**
+		 * \brief   Retrieves the limits of the process' cgroup v2 hierarchy.
+		 * \details This property is cached with
+		 *          \c System::CachePolicy::Volatile.
+		 * \return  The limits.
+		 * \throws  std::system_error if the hierarchy could not be found.
+		 */
+		System::CgroupLimits ResourceLimits();
+
+		/**
+		 * \brief   Retrieves the number of CPUs the process can actually use.
+		 * \details This is the number of logical CPUs, reduced to the size of
+		 *          the cgroup's cpuset and to its CPU quota, rounded up. Size
+		 *          thread pools by this rather than by the CPU count inside a
+		 *          container. Without a sysfs topology, the count comes from
+		 *          \c /proc/cpuinfo, then from
+		 *          \c std::thread::hardware_concurrency(); without a cgroup v2
+		 *          hierarchy, no limits apply.
+		 * \return  The usable CPU count, which is at least 1.
+		 */
+		std::uint32_t EffectiveCPUCount();
+
+		/**
+		 * \brief   Retrieves the memory the process can actually use, in bytes.
+		 * \details This is \c RAMTotalBytes(), reduced to the cgroup's memory
+		 *          limit. Allocating beyond it gets the process OOM-killed.
+		 *          Without a cgroup v2 hierarchy, no limit applies.
+		 * \return  The usable memory, in bytes.
+		 * \throws  std::system_error if the memory could not be read.
+		 */
+		std::uint64_t EffectiveRAMBytes();
+
+		/**
+		 * \brief   Retrieves the Pressure Stall Information of the system.
+		 * \details This property is cached with
+		 *          \c System::CachePolicy::Volatile. To be woken when stalls
+		 *          exceed a budget instead, use a \c System::PressureMonitor.
+		 * \return  The pressure on each resource, read from
+		 *          \c /proc/pressure.
+		 * \throws  std::system_error if PSI is unavailable, e.g. because the
+		 *          kernel was booted with \c psi=0.
+		 */
+		System::PressureSnapshot Pressure();
+
+		/**
+		 * \brief   Retrieves the Pressure Stall Information of the process'
+		 *          cgroup.
+		 * \details This property is cached with
+		 *          \c System::CachePolicy::Volatile.
+		 * \return  The pressure on each resource, read from the cgroup's
+		 *          \c cpu.pressure, \c memory.pressure and \c io.pressure.
+		 * \throws  std::system_error if the process isn't in a cgroup v2
+		 *          hierarchy, or its PSI files could not be read.
+		 */
+		System::PressureSnapshot CgroupPressure();
+#endif
+
+		/**
+		 * \brief  Retrieves the name of the OS the machine is running.
+		 * \return User-friendly OS name.
+		 * \throws std::system_error if the the request failed. An OS-specific
+		 *         code and error string will be generated.
+		 */
+		std::string OSName();
+
+		/**
+		 * \brief  Retrieves the version of the OS the machine is running.
+		 * \return Version string.
+		 * \throws std::system_error if the the request failed. An OS-specific
+		 *         code and error string will be generated.
+		 */
+		std::string OSVersion();
+
+#ifdef __linux__
+		/**
+		 * \brief   Retrieves the identity of the kernel and the distribution.
+		 * \details This is probed once, with a single \c uname() call and a
+		 *          read of \c /etc/os-release (or \c /usr/lib/os-release), and
+		 *          cached with \c System::CachePolicy::Static. The identity is
+		 *          immutable, so it can be shared between threads, and
+		 *          retrieving it again doesn't allocate. \c OSName(),
+		 *          \c OSVersion() and \c GPUDriver() are derived from it.
+		 * \return  The OS identity.
+		 * \throws  std::system_error if \c uname() failed.
+		 */
+		std::shared_ptr<const System::OSIdentity> OSDetails();
+#endif
+
+		/**
+		 * \brief   Retrieves the vendor of the currently installed GPU.
+		 * \details On Linux, the name is resolved from the system's \c pci.ids
+		 *          database. If it can't be found, the hexadecimal PCI vendor ID
+		 *          is returned instead.
+		 * \return  The name of the vendor of the installed GPU.
+		 * \throws  std::system_error if the the request failed. An OS-specific
+		 *          code and error string will be generated.
+		 */
+		std::string GPUVendor();
+
+		/**
+		 * \brief   Retrieves the name of the currently installed GPU.
+		 * \details On Linux, the name is resolved from the system's \c pci.ids
+		 *          database. If it can't be found, the hexadecimal PCI device ID
+		 *          is returned instead.
+		 * \return  User-friendly name of the installed GPU.
+		 * \throws  std::system_error if the the request failed. An OS-specific
+		 *          code and error string will be generated.
+		 */
+		std::string GPUName();
+
+		/**
+		 * \brief   Retrieves the version of the driver the installed GPU is using.
+		 * \details On Linux, this is the version reported by the driver's kernel
+		 *          module. Drivers shipped with the kernel usually don't report
+		 *          one, in which case the kernel release is returned instead.
+		 * \return  Version string.
+		 * \throws  std::system_error if the the request failed. An OS-specific
+		 *          code and error string will be generated.
+		 */
+		std::string GPUDriver();
+
+		/**
+		 * \brief   Retrieves every GPU of the machine.
+		 * \details \c GPUVendor(), \c GPUName() and \c GPUDriver() describe the
+		 *          first GPU of this inventory.
+		 * \return  The GPUs, which may be empty.
+		 * \throws  std::system_error if the request failed. An OS-specific
+		 *          code and error string will be generated.
+		 */
+		std::shared_ptr<const System::GPUInventory> gpus();
+
+		/**
+		 * \brief   Retrieves every physical CPU package of the machine.
+		 * \details On Windows, \c CPUModel() describes the first package of
+		 *          this inventory.
+		 * \return  The packages.
+		 * \throws  std::system_error if the request failed. An OS-specific
+		 *          code and error string will be generated.
+		 */
+		std::shared_ptr<const System::CPUPackageInventory> cpuPackages();
+
+		/**
+		 * \brief   Retrieves every RAM module installed in the machine.
+		 * \details On Windows, \c RAMTotalBytes() is the sum of this
+		 *          inventory's sizes. On Linux, the modules are read from the
+		 *          SMBIOS tables, which usually only root can read.
+		 * \return  The modules, which may be empty.
+		 * \throws  std::system_error if the request failed. An OS-specific
+		 *          code and error string will be generated.
+		 */
+		std::shared_ptr<const System::MemoryModuleInventory> memoryModules();
+
+		/**
+		 * \brief  Retrieves every physical disk attached to the machine.
+		 * \return The disks.
+		 * \throws std::system_error if the request failed. An OS-specific
+		 *         code and error string will be generated.
+		 */
+		std::shared_ptr<const System::DiskInventory> disks();
+
+		/**
+		 * \brief  Retrieves the capacity of the drive the program is running on.
+		 * \param  unit The unit of memory to return the capacity in. By default,
+		 *              it is \c System::Unit::GB.
+		 * \return The capacity of the drive.
+		 * \throws std::filesystem_error if the the request failed. An OS-specific
+		 *         code and error string will be generated.
+		 */
+		std::string StorageTotal(const System::Unit unit = System::Unit::GB);
+
+		/**
+		 * \brief  Retrieves the capacity of the drive the program is running on,
+		 *         in bytes.
+		 * \return The capacity of the drive, in bytes.
+		 * \throws std::filesystem_error if the the request failed. An OS-specific
+		 *         code and error string will be generated.
+		 */
+		std::uint64_t StorageTotalBytes();
+
+		/**
+		 * \brief  Retrieves the amount of free space on the drive the program is
+		 *         running on.
+		 * \param  unit The unit of memory to return the free space in. By default,
+		 *              it is \c System::Unit::GB.
+		 * \return The free space of the drive.
+		 * \throws std::filesystem_error if the the request failed. An OS-specific
+		 *         code and error string will be generated.
+		 */
+		std::string StorageFree(const System::Unit unit = System::Unit::GB);
+
+		/**
+		 * \brief  Retrieves the amount of free space on the drive the program is
+		 *         running on, in bytes.
+		 * \return The free space of the drive, in bytes.
+		 * \throws std::filesystem_error if the the request failed. An OS-specific
+		 *         code and error string will be generated.
+		 */
+		std::uint64_t StorageFreeBytes();
+
+		/**
+		 * \brief   Retrieves every mounted filesystem and its capacity.
+		 * \details Unlike the other accessors, this is not cached: the mounts are
+		 *          enumerated and queried on every call.
+		 * \param   options Controls how the mounts are queried.
+		 * \return  The mounts.
+		 * \throws  std::system_error if the mounts could not be enumerated.
+		 * \sa      \c System::enumerateMounts()
+		 */
+		std::vector<System::Mount> mounts(
+			const System::MountOptions& options = System::MountOptions());
+
+		/**
+		 * \brief  Retrieves the filesystem a path is stored on, and its capacity.
+		 * \param  path    The path to look up, relative to the root filesystem
+		 *                 given to the constructor. It must exist.
+		 * \param  options Controls how the mount is queried.
+		 * \return The mount the path is stored on.
+		 * \throws std::system_error if the path or the mounts could not be
+		 *         resolved.
+		 * \sa     \c System::mountOf()
+		 */
+		System::Mount mountOf(const std::filesystem::path& path,
+			const System::MountOptions& options = System::MountOptions());
+
+#ifdef __linux__
+		/**
+		 * \brief   Measures block device I/O since the previous call.
+		 * \details The first call measures I/O since boot. This property is
+		 *          cached with \c System::CachePolicy::Volatile, so the
+		 *          measuring interval is at least the volatile lifetime. To
+		 *          sample at a specific rate, use a dedicated
+		 *          \c System::DiskSampler. Use \c System::DiskUsage::find() to
+		 *          look up the device behind one of \c mounts().
+		 * \return  The I/O rates of every block device.
+		 * \throws  std::system_error if \c /proc/diskstats could not be read.
+		 */
+		System::DiskUsage StorageLoad();
+
+		/**
+		 * \brief   Retrieves the machine's network interfaces.
+		 * \details This property is cached with
+		 *          \c System::CachePolicy::Volatile. Addresses are only looked
+		 *          up when reading the running kernel's trees.
+		 * \return  The interfaces, as returned by
+		 *          \c System::enumerateNetworkInterfaces().
+		 * \throws  std::system_error if the addresses could not be looked up.
+		 */
+		std::vector<System::NetworkInterface> NetworkInterfaces();
+
+		/**
+		 * \brief   Retrieves the network traffic since the last call.
+		 * \details This property is cached with
+		 *          \c System::CachePolicy::Volatile. The first call measures
+		 *          the traffic since the interfaces were created. To poll at a
+		 *          high frequency, use a dedicated \c System::NetworkSampler
+		 *          instead.
+		 * \return  The traffic rates of each interface.
+		 * \throws  std::system_error if \c /proc/net/dev could not be read.
+		 */
+		System::NetworkUsage NetworkLoad();
+#endif
+
+		/**
+		 * \brief Drops every cached property, including cached failures, so that
+		 *        the next call to each accessor probes the computer again.
+		 */
+		void invalidate() noexcept;
+
+		/**
+		 * \brief Sets how long \c System::CachePolicy::Volatile properties are
+		 *        cached for.
+		 * \param lifetime The new lifetime. By default, it is one second. A
+		 *                 lifetime of zero disables caching of these properties.
+		 */
+		void setVolatileLifetime(const std::chrono::milliseconds lifetime)
+			noexcept;
+
+		/**
+		 * \brief   Retrieves the counters of every cached probe.
+		 * \details The counters are kept from construction, or from the last
+		 *          call to \c resetProbeStats(), and aren't affected by
+		 *          \c invalidate(). If the library was built with
+		 *          \c _SYSTEM_PROPERTIES_NO_INSTRUMENTATION defined, nothing is
+		 *          recorded and an empty list is returned.
+		 * \return  The counters of each probe, in a fixed order.
+		 */
+		std::vector<System::ProbeStats> probeStats() const;
+
+		/**
+		 * \brief Zeroes the counters of every cached probe.
+		 */
+		void resetProbeStats() noexcept;
+
+		/**
+		 * \brief   Sets the function which receives every accessor call.
+		 * \details It does nothing if the library was built with
+		 *          \c _SYSTEM_PROPERTIES_NO_INSTRUMENTATION defined.
+		 * \param   hook The new hook, or an empty function to stop tracing.
+		 */
+		void setTraceHook(System::TraceHook hook);
+
+		/**
+		 * \brief   Probes the given properties concurrently in the background.
+		 * \details The probes are run on a small internal thread pool, which is
+		 *          started on first use. Their results are stored in the same
+		 *          caches the accessors use, so collecting every property takes
+		 *          about as long as the slowest probe.\n
+		 *          This object must outlive the returned handle's probes: the
+		 *          destructor finishes any probes which are still queued.
+		 * \param   properties The properties to probe.
+		 * \return  Handle through which the probes can be awaited.
+		 */
+		System::Prefetch prefetch(
+			const std::initializer_list<System::Property> properties);
+
+		/**
+		 * \brief  Probes every property concurrently in the background.
+		 * \return Handle through which the probes can be awaited.
+		 * \sa     \c prefetch()
+		 */
+		System::Prefetch prefetchAll();
+
+		/**
+		 * \brief Identifies a subscription made with \c subscribe().
+		 */
+		typedef std::uint64_t Subscription;
+
+		/**
+		 * \brief   Called when tracked properties change.
+		 * \details It receives the previous and current values, and the
+		 *          tracked properties which differ between them.
+		 */
+		typedef std::function<void(const System::Snapshot& before,
+			const System::Snapshot& after,
+			const std::vector<System::Property>& changed)> ChangeCallback;
+
+		/**
+		 * \brief Called when a property crosses a threshold, with the property
+		 *        and its new value in bytes.
+		 */
+		typedef std::function<void(const System::Property property,
+			const std::uint64_t value)> ThresholdCallback;
+
+		/**
+		 * \brief   Calls back whenever any of the given properties changes.
+		 * \details The properties are watched on one background thread, which
+		 *          is started by the first subscription. It doesn't poll every
+		 *          property: it re-probes properties only when a cheap signal
+		 *          says they may have changed. On Linux, a change to
+		 *          \c mountinfo re-probes storage, and a device hotplug uevent
+		 *          re-probes the affected hardware. On every platform, the
+		 *          volatile properties are re-probed once per poll interval.\n
+		 *          The callback runs on the background thread, and only after
+		 *          a value actually changes: the values when the subscription
+		 *          is first seen are its baseline. A property which starts or
+		 *          stops failing counts as a change.
+		 * \param   properties The properties to track.
+		 * \param   callback   The function to call. It should not throw, and
+		 *                     it may call \c unsubscribe().
+		 * \return  The subscription's handle.
+		 */
+		Subscription subscribe(
+			const std::initializer_list<System::Property> properties,
+			System::Properties::ChangeCallback callback);
+
+		/**
+		 * \brief   Calls back whenever a size property crosses a limit.
+		 * \details The callback fires once when the value is first seen on the
+		 *          \c threshold side of \c limit, including when the
+		 *          subscription is first seen, and fires again only after the
+		 *          value has gone back. It is watched the same way as the other
+		 *          overload.
+		 * \param   property  The property to track. It must be a size:
+		 *                    \c RAMTotal, \c StorageTotal or \c StorageFree.
+		 * \param   threshold Which side of the limit to fire on.
+		 * \param   limit     The limit, in bytes.
+		 * \param   callback  The function to call. It should not throw, and it
+		 *                    may call \c unsubscribe().
+		 * \return  The subscription's handle.
+		 * \throws  std::system_error if the property isn't a size.
+		 */
+		Subscription subscribe(const System::Property property,
+			const System::Threshold threshold, const std::uint64_t limit,
+			System::Properties::ThresholdCallback callback);
+
+		/**
+		 * \brief   Cancels a subscription.
+		 * \details If the background thread is running the subscription's
+		 *          callback at the time, it finishes doing so.
+		 * \param   subscription The handle returned by \c subscribe(). Unknown
+		 *                       handles are ignored.
+		 */
+		void unsubscribe(const Subscription subscription) noexcept;
+
+		/**
+		 * \brief Sets how often subscriptions re-probe volatile properties.
+		 * \param interval The new interval. By default, it is one second.
+		 */
+		void setPollInterval(const std::chrono::milliseconds interval) noexcept;
+	private:
+		/**
+		 * \brief   A small pool of worker threads which run queued tasks in order.
+		 * \details The threads are started when the first task is submitted.
+		 */
+		class Workers {
+		public:
+			/**
+			 * \brief The number of threads in the pool.
+			 */
+			static constexpr std::size_t THREADS = 4;
+
+			/**
+			 * \brief Finishes every queued task and joins the threads.
+			 */
+			~Workers() noexcept;
+
+			/**
+			 * \brief Queues a task, starting the threads if necessary.
+			 * \param task The task to run. It must not throw.
+			 */
+			void submit(std::function<void()> task);
+
+			/**
+			 * \brief Finishes every queued task and joins the threads. Tasks
+			 *        submitted afterwards restart the pool.
+			 */
+			void stop() noexcept;
+		private:
+			/**
+			 * \brief The loop each thread runs.
+			 */
+			void _run() noexcept;
+
+			/**
+			 * \brief Guards every other member.
+			 */
+			std::mutex _mutex;
+
+			/**
+			 * \brief Signalled when a task is queued or the pool is stopping.
+			 */
+			std::condition_variable _signal;
+
+			/**
+			 * \brief The tasks waiting to be run.
+			 */
+			std::deque<std::function<void()>> _tasks;
+
+			/**
+			 * \brief The threads of the pool.
+			 */
+			std::vector<std::thread> _threads;
+
+			/**
+			 * \brief \c TRUE if the threads should exit once the queue is empty.
+			 */
+			bool _stopping = false;
+		};
+
+		/**
+		 * \brief  Runs a property's accessor, discarding its result.
+		 * \param  property The property to probe.
+		 * \throws Whatever the accessor threw, if it failed.
+		 */
+		void _probe(const System::Property property);
+
+		/**
+		 * \brief The state of a subscription, which is only touched by the
+		 *        background thread once it has been made.
+		 */
+		struct Subscriber {
+			/**
+			 * \brief Bitmask of the tracked properties.
+			 */
+			std::uint32_t properties = 0;
+
+			/**
+			 * \brief The callback of a change subscription.
+			 */
+			System::Properties::ChangeCallback onChange;
+
+			/**
+			 * \brief The callback of a threshold subscription.
+			 */
+			System::Properties::ThresholdCallback onThreshold;
+
+			/**
+			 * \brief The tracked property of a threshold subscription.
+			 */
+			System::Property property = System::Property::StorageFree;
+
+			/**
+			 * \brief Which side of the limit a threshold subscription fires on.
+			 */
+			System::Threshold threshold = System::Threshold::Below;
+
+			/**
+			 * \brief The limit of a threshold subscription.
+			 */
+			std::uint64_t limit = 0;
+
+			/**
+			 * \brief \c TRUE once the baseline has been taken.
+			 */
+			bool primed = false;
+
+			/**
+			 * \brief \c TRUE while the value is beyond the limit.
+			 */
+			bool crossed = false;
+
+			/**
+			 * \brief The values seen last.
+			 */
+			System::Snapshot last;
+		};
+
+		/**
+		 * \brief  Retrieves some of the properties, leaving failed ones absent.
+		 * \param  properties Bitmask of the properties to retrieve.
+		 * \return The snapshot.
+		 */
+		System::Snapshot _snapshot(const std::uint32_t properties);
+
+		/**
+		 * \brief Drops the cached values of some properties, including any
+		 *        state they share with other properties.
+		 * \param properties Bitmask of the properties to drop.
+		 */
+		void _invalidate(const std::uint32_t properties) noexcept;
+
+		/**
+		 * \brief Re-probes the tracked properties and runs the callbacks of
+		 *        those which changed.
+		 * \param invalidated Bitmask of the properties whose caches should be
+		 *                    dropped first.
+		 */
+		void _notify(const std::uint32_t invalidated);
+
+		/**
+		 * \brief   Starts a subscription.
+		 * \param   subscriber The subscription's state.
+		 * \return  The subscription's handle.
+		 */
+		Subscription _subscribe(std::shared_ptr<Subscriber> subscriber);
+
+		/**
+		 * \brief The loop the background thread runs until \c _stopWatching().
+		 */
+		void _watch() noexcept;
+
+		/**
+		 * \brief   Wakes the background thread up so that it handles new
+		 *          subscriptions or stops.
+		 * \details \c _watchMutex must be locked, as it guards \c _watchFd.
+		 */
+		void _wakeWatcher() noexcept;
+
+		/**
+		 * \brief Stops and joins the background thread, if it is running.
+		 */
+		void _stopWatching() noexcept;
+		/**
+		 * \brief Type-erased interface to a cached property, used to reset every
+		 *        cache at once.
+		 */
+		class CacheEntry {
+		public:
+			/**
+			 * \brief Names the probe.
+			 * \param name The name of the accessor which owns the probe.
+			 */
+			explicit CacheEntry(const std::string_view name) noexcept :
+				_name(name) {}
+
+			/**
+			 * \brief Polymorphic base classes require virtual destructors.
+			 */
+			virtual ~CacheEntry() noexcept = default;
+
+			/**
+			 * \brief Drops the cached result.
+			 */
+			virtual void reset() noexcept = 0;
+
+			/**
+			 * \brief  Copies the probe's counters.
+			 * \return The counters.
+			 */
+			System::ProbeStats stats() const noexcept;
+
+			/**
+			 * \brief Zeroes the probe's counters.
+			 */
+			void resetStats() noexcept;
+		protected:
+			/**
+			 * \brief Counts an accessor call, and reports it to the trace hook.
+			 * \param hit      \c TRUE if the call returned a cached result.
+			 * \param failed   \c TRUE if the call threw.
+			 * \param duration How long the probe took, if it was run.
+			 * \param hook     The trace hook, or \c nullptr.
+			 */
+#ifdef _SYSTEM_PROPERTIES_NO_INSTRUMENTATION
+			void _record(const bool, const bool, const std::chrono::nanoseconds,
+				const System::TraceHook*) noexcept {}
+#else
+			void _record(const bool hit, const bool failed,
+				const std::chrono::nanoseconds duration,
+				const System::TraceHook* hook) noexcept;
+#endif
+
+			/**
+			 * \brief The name of the accessor which owns the probe.
+			 */
+			const std::string_view _name;
+#ifndef _SYSTEM_PROPERTIES_NO_INSTRUMENTATION
+		private:
+			/**
+			 * \brief The number of cache hits.
+			 */
+			std::atomic<std::uint64_t> _hits{ 0 };
+
+			/**
+			 * \brief The number of cache misses.
+			 */
+			std::atomic<std::uint64_t> _misses{ 0 };
+
+			/**
+			 * \brief The number of probe runs which threw.
+			 */
+			std::atomic<std::uint64_t> _failures{ 0 };
+
+			/**
+			 * \brief The time spent running the probe, in nanoseconds.
+			 */
+			std::atomic<std::uint64_t> _totalTime{ 0 };
+
+			/**
+			 * \brief The longest run of the probe, in nanoseconds.
+			 */
+			std::atomic<std::uint64_t> _maxTime{ 0 };
+
+			/**
+			 * \brief The number of probe runs in each latency bucket.
+			 */
+			std::array<std::atomic<std::uint64_t>, System::ProbeStats::BUCKETS>
+				_histogram{};
+#endif
+		};
+
+		/**
+		 * \brief   Caches the result of a single property probe.
+		 * \details The probe is run while a lock is held, so concurrent callers
+		 *          wait for one probe instead of each running their own. Failures
+		 *          are cached in the same way as results, and are rethrown to
+		 *          every caller until the entry expires.
+		 * \tparam  T The type of value returned by the probe.
+		 */
+		template<typename T>
+		class Cache : public CacheEntry {
+		public:
+			/**
+			 * \brief Registers the cache with its owner.
+			 * \param registry The list of caches to reset in
+			 *                 \c Properties::invalidate().
+			 * \param name     The name of the accessor which owns the probe.
+			 * \param policy   How long the result is cached for.
+			 */
+			Cache(std::vector<CacheEntry*>& registry,
+				const std::string_view name, const System::CachePolicy policy) :
+				CacheEntry(name), _policy(policy) {
+				registry.push_back(this);
+			}
+
+			/**
+			 * \brief  Retrieves the cached result, running the probe first if there
+			 *         is no result or it has expired.
+			 * \param  lifetime How long volatile results are cached for.
+			 * \param  probe    The function which computes the result.
+			 * \param  hook     The trace hook to report the call to, or
+			 *                  \c nullptr.
+			 * \return The cached result.
+			 * \throws Whatever the probe threw, if it failed.
+			 */
+			template<typename Probe>
+			T get(const std::chrono::steady_clock::duration lifetime,
+				Probe&& probe, const System::TraceHook* hook) {
+				std::unique_lock<std::mutex> lock(_mutex);
+				const auto now = std::chrono::steady_clock::now();
+				bool hit = true;
+				std::chrono::nanoseconds duration(0);
+				if (!_ready || (_policy == System::CachePolicy::Volatile &&
+					now - _stamp >= lifetime)) {
+					try {
+						_value = probe();
+						_error = nullptr;
+					} catch (...) {
+						_value = T();
+						_error = std::current_exception();
+					}
+					_ready = true;
+					_stamp = now;
+					hit = false;
+#ifndef _SYSTEM_PROPERTIES_NO_INSTRUMENTATION
+					duration = std::chrono::steady_clock::now() - now;
+#endif
+				}
+				T value = _value;
+				const std::exception_ptr error = _error;
+				lock.unlock();
+				_record(hit, error != nullptr, duration, hook);
+				if (error) std::rethrow_exception(error);
+				return value;
+			}
+
+			/**
+			 * \brief Drops the cached result.
+			 */
+			void reset() noexcept override {
+				std::lock_guard<std::mutex> lock(_mutex);
+				_ready = false;
+				_error = nullptr;
+			}
+		private:
+			/**
+			 * \brief Guards every other member.
+			 */
+			std::mutex _mutex;
+
+			/**
+			 * \brief How long the result is cached for.
+			 */
+			const System::CachePolicy _policy;
+
+			/**
+			 * \brief \c TRUE if the probe has been run since the last reset.
+			 */
+			bool _ready = false;
+
+			/**
+			 * \brief The cached result.
+			 */
+			T _value = T();
+
+			/**
+			 * \brief The cached failure, if the probe failed.
+			 */
+			std::exception_ptr _error;
+
+			/**
+			 * \brief When the probe was last run.
+			 */
+			std::chrono::steady_clock::time_point _stamp;
+		};
+
+		/**
+		 * \brief  Retrieves a property through its cache.
+		 * \param  cache The cache of the property.
+		 * \param  probe The function which computes the property.
+		 * \return The property.
+		 * \throws Whatever the probe threw, if it failed.
+		 */
+		template<typename T, typename Probe>
+		T _cached(Cache<T>& cache, Probe&& probe) {
+			const std::chrono::milliseconds lifetime(_volatileLifetime.load());
+#ifdef _SYSTEM_PROPERTIES_NO_INSTRUMENTATION
+			return cache.get(lifetime, std::forward<Probe>(probe), nullptr);
+#else
+			std::shared_ptr<const System::TraceHook> hook;
+			if (_tracing.load(std::memory_order_relaxed)) {
+				std::lock_guard<std::mutex> lock(_traceMutex);
+				hook = _traceHook;
+			}
+			return cache.get(lifetime, std::forward<Probe>(probe), hook.get());
+#endif
+		}
+
+		/**
+		 * \brief The filesystem trees every probe reads from.
+		 */
+		const System::Roots _roots;
+
+		/**
+		 * \brief Every cache declared below, in declaration order.
+		 */
+		std::vector<CacheEntry*> _caches;
+
+		/**
+		 * \brief How long volatile properties are cached for, in milliseconds.
+		 */
+		std::atomic<std::int64_t> _volatileLifetime{ 1000 };
+
+		/**
+		 * \brief   The hook set via \c setTraceHook(), or \c nullptr.
+		 * \details It is copied out whilst \c _traceMutex is locked, so that it
+		 *          can be replaced whilst another thread is calling it.
+		 */
+		std::shared_ptr<const System::TraceHook> _traceHook;
+
+		/**
+		 * \brief Guards \c _traceHook.
+		 */
+		std::mutex _traceMutex;
+
+		/**
+		 * \brief \c TRUE if \c _traceHook is set, so that untraced calls don't
+		 *        lock \c _traceMutex.
+		 */
+		std::atomic<bool> _tracing{ false };
+
+		/**
+		 * \brief The cached CPU model.
+		 */
+		Cache<std::string> _cpuModel{ _caches, "CPUModel",
+			System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached CPU architecture.
+		 */
+		Cache<std::string> _cpuArchitecture{ _caches, "CPUArchitecture",
+			System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached total RAM, in bytes.
+		 */
+		Cache<std::uint64_t> _ramTotal{ _caches, "RAMTotalBytes",
+			System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached OS name.
+		 */
+		Cache<std::string> _osName{ _caches, "OSName",
+			System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached OS version.
+		 */
+		Cache<std::string> _osVersion{ _caches, "OSVersion",
+			System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached GPU vendor.
+		 */
+		Cache<std::string> _gpuVendor{ _caches, "GPUVendor",
+			System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached GPU name.
+		 */
+		Cache<std::string> _gpuName{ _caches, "GPUName",
+			System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached GPU driver version.
+		 */
+		Cache<std::string> _gpuDriver{ _caches, "GPUDriver",
+			System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached storage capacity, in bytes.
+		 */
+		Cache<std::uint64_t> _storageTotal{ _caches, "StorageTotalBytes",
+			System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached free storage, in bytes.
+		 */
+		Cache<std::uint64_t> _storageFree{ _caches, "StorageFreeBytes",
+			System::CachePolicy::Volatile };
+
+		/**
+		 * \brief   The cached result of \c gpus().
+		 * \details This lets the three GPU accessors share one enumeration.
+		 */
+		Cache<std::shared_ptr<const System::GPUInventory>> _gpus{ _caches,
+			"gpus", System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached result of \c cpuPackages().
+		 */
+		Cache<std::shared_ptr<const System::CPUPackageInventory>> _cpuPackages{
+			_caches, "cpuPackages", System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached result of \c memoryModules().
+		 */
+		Cache<std::shared_ptr<const System::MemoryModuleInventory>>
+			_memoryModules{ _caches, "memoryModules",
+			System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached result of \c disks().
+		 */
+		Cache<std::shared_ptr<const System::DiskInventory>> _disks{ _caches,
+			"disks", System::CachePolicy::Static };
+#ifdef _WIN32
+		/**
+		 * \brief   The WMI classes read by the accessors.
+		 * \details The backend starts its COM thread, and connects to
+		 *          \c ROOT\\CIMV2, on the first query.
+		 */
+		System::WMIClient _wmi;
+#elif __linux__
+		/**
+		 * \brief  Make a query for CPU information.
+		 * \param  objectName Name of the piece of CPU information to retrieve.
+		 * \return The piece of CPU information requested.
+		 * \throws std::system_error if the the request failed. A file I/O code and
+		 *         error string will be generated.
+		 */
+		std::string _cpuRequest(const std::string& objectName);
+
+		/**
+		 * \brief  Retrieves the cgroup limits, treating a missing hierarchy as
+		 *         no limits at all.
+		 * \return The result of \c ResourceLimits(), or a default
+		 *         \c System::CgroupLimits if it could not be read.
+		 */
+		System::CgroupLimits _limitsOrNone();
+
+		/**
+		 * \brief   The parsed \c /proc/cpuinfo snapshot.
+		 * \details This is \c nullptr until the first CPU query is made.
+		 */
+		std::shared_ptr<const System::CPUInfo> _cpuInfo;
+
+		/**
+		 * \brief Guards \c _cpuInfo.
+		 */
+		std::mutex _cpuInfoMutex;
+
+		/**
+		 * \brief   The sampler behind \c RAMStats().
+		 * \details This is created on first use, and is only accessed whilst
+		 *          \c _ramStats is locked.
+		 */
+		std::unique_ptr<System::MemorySampler> _memorySampler;
+
+		/**
+		 * \brief The cached memory figures.
+		 */
+		Cache<System::MemoryStats> _ramStats{ _caches, "RAMStats",
+			System::CachePolicy::Volatile };
+
+		/**
+		 * \brief   The sampler behind \c CPULoad().
+		 * \details This is created on first use, and is only accessed whilst
+		 *          \c _cpuLoad is locked.
+		 */
+		std::unique_ptr<System::CPUSampler> _cpuSampler;
+
+		/**
+		 * \brief The cached CPU utilisation.
+		 */
+		Cache<System::CPUUsage> _cpuLoad{ _caches, "CPULoad",
+			System::CachePolicy::Volatile };
+
+		/**
+		 * \brief   The sampler behind \c StorageLoad().
+		 * \details This is created on first use, and is only accessed whilst
+		 *          \c _storageLoad is locked.
+		 */
+		std::unique_ptr<System::DiskSampler> _diskSampler;
+
+		/**
+		 * \brief The cached block device I/O rates.
+		 */
+		Cache<System::DiskUsage> _storageLoad{ _caches, "StorageLoad",
+			System::CachePolicy::Volatile };
+
+		/**
+		 * \brief The cached result of \c NetworkInterfaces().
+		 */
+		Cache<std::vector<System::NetworkInterface>> _networkInterfaces{
+			_caches, "NetworkInterfaces", System::CachePolicy::Volatile };
+
+		/**
+		 * \brief   The sampler behind \c NetworkLoad().
+		 * \details This is created on first use, and is only accessed whilst
+		 *          \c _networkLoad is locked.
+		 */
+		std::unique_ptr<System::NetworkSampler> _networkSampler;
+
+		/**
+		 * \brief The cached result of \c NetworkLoad().
+		 */
+		Cache<System::NetworkUsage> _networkLoad{ _caches, "NetworkLoad",
+			System::CachePolicy::Volatile };
+
+		/**
+		 * \brief The cached result of \c ResourceLimits().
+		 */
+		Cache<System::CgroupLimits> _resourceLimits{ _caches, "ResourceLimits",
+			System::CachePolicy::Volatile };
+
+		/**
+		 * \brief The cached result of \c Pressure().
+		 */
+		Cache<System::PressureSnapshot> _pressure{ _caches, "Pressure",
+			System::CachePolicy::Volatile };
+
+		/**
+		 * \brief The cached result of \c CgroupPressure().
+		 */
+		Cache<System::PressureSnapshot> _cgroupPressure{ _caches,
+			"CgroupPressure", System::CachePolicy::Volatile };
+
+		/**
+		 * \brief   The sampler behind \c process().
+		 * \details This is created on first use, and is only accessed whilst
+		 *          \c _processMutex is locked.
+		 */
+		std::unique_ptr<System::ProcessSampler> _processSampler;
+
+		/**
+		 * \brief Guards \c _processSampler.
+		 */
+		std::mutex _processMutex;
+
+		/**
+		 * \brief The cached CPU topology.
+		 */
+		Cache<std::shared_ptr<const System::Topology>> _cpuTopology{ _caches,
+			"CPUTopology", System::CachePolicy::Static };
+
+		/**
+		 * \brief The cached OS identity.
+		 */
+		Cache<std::shared_ptr<const System::OSIdentity>> _osDetails{ _caches,
+			"OSDetails", System::CachePolicy::Static };
+#elif __APPLE__
+		// any macOS-only data required goes here
+		// also any macOS-only helper methods should be declared here
+#endif
+
+		/**
+		 * \brief Guards the subscription state below.
+		 */
+		std::mutex _watchMutex;
+
+		/**
+		 * \brief Signals the background thread, on platforms where it doesn't
+		 *        wait on \c _watchFd.
+		 */
+		std::condition_variable _watchWake;
+
+		/**
+		 * \brief The subscriptions, by handle.
+		 */
+		std::unordered_map<Subscription, std::shared_ptr<Subscriber>>
+			_subscribers;
+
+		/**
+		 * \brief The handle of the next subscription.
+		 */
+		Subscription _nextSubscription = 1;
+
+		/**
+		 * \brief \c TRUE if subscriptions were added since the background
+		 *        thread last ran.
+		 */
+		bool _watchPending = false;
+
+		/**
+		 * \brief \c TRUE if the background thread should exit.
+		 */
+		bool _watchStopping = false;
+
+		/**
+		 * \brief The \c eventfd which wakes the background thread, on Linux.
+		 */
+		int _watchFd = -1;
+
+		/**
+		 * \brief How often volatile properties are re-probed, in milliseconds.
+		 */
+		std::atomic<std::int64_t> _pollInterval{ 1000 };
+
+		/**
+		 * \brief The background thread, which is started by the first
+		 *        subscription.
+		 */
+		std::thread _watcher;
+
+		/**
+		 * \brief   The thread pool which runs prefetches.
+		 * \details This is declared last so that it is destroyed first, whilst
+		 *          every probe's state is still alive.
+		 */
+		Workers _workers;
+	};
+}
+
+#ifdef _WIN32
+	// just in case leaving this in could cause problems in another's Windows code
+	// idk if this is even a useful thing to do, but it can't hurt... hopefully...
+	#ifndef _SYSTEM_PROPERTIES_DO_NOT_UNDEF
+		#undef _WIN32_DCOM
+	#endif
+	#ifndef _SYSTEM_PROPERTIES_KEEP_NOMINMAX
+		#undef NOMINMAX
 	#endif
 #endif
\ No newline at end of file
@@ -0,0 +1,1248 @@
+/*MIT License
+
+Copyright (c) 2021 CasualYouTuber31 <naysar@protonmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+/**@file SystemPropertiesBenchmark.cpp
+ * Measures the cost of every \c System::Properties accessor and every
+ * lower-level probe.
+ *
+ * Each benchmark is run cold, on a fresh object, and warm, on an object which
+ * has already been called once. For both, the latency, the number of heap
+ * allocations, the number of \c read() and \c write() system calls, and the
+ * number of processes forked are reported per call.
+ *
+ * Usage:
+ * \code
+ * SystemPropertiesBenchmark [options]
+ *     --root DIR        run against a fixture tree containing proc/ and sys/,
+ *                       instead of the live system
+ *     --capture DIR     copy the live files the probes read into DIR
+ *     --synthesize DIR  write a synthetic fixture tree into DIR
+ *     --cpus N          logical CPUs in a synthetic tree (default 64)
+ *     --disks N         block devices in a synthetic tree (default 16)
+ *     --mounts N        mounts in a synthetic tree (default 32)
+ *     --interfaces N    network interfaces in a synthetic tree (default 8)
+ *     --cold N          cold runs per benchmark (default 20)
+ *     --warm N          warm calls per benchmark (default 10000)
+ *     --lifetime MS     volatile cache lifetime (default 1000)
+ *     --batch N         snapshots in the encoding batch (default 100000)
+ *     --filter TEXT     only run benchmarks whose name contains TEXT
+ * \endcode
+ *
+ * The system call and fork counts are only available on Linux. The fork count
+ * is read from the system-wide counter in \c /proc/stat, which also counts
+ * threads, so the minimum across the cold runs is reported to filter out other
+ * processes.
+ *
+ * The WMI query layer is measured on every platform against a fake backend
+ * which simulates the round trip of each query.
+ *
+ * Finally, the throughput of encoding, decoding and formatting a large batch
+ * of \c System::Snapshot values is measured, followed by the throughput of
+ * the procfs parsers against the \c std::getline() approach they replaced.
+ */
+
+#include "SystemProperties.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+
+#ifdef __linux__
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace {
+	/**
+	 * \brief The number of heap allocations made by the whole program.
+	 */
+	std::atomic<std::uint64_t> allocations{ 0 };
+}
+
+void* operator new(std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+namespace {
+	/**
+	 * \brief The resources counted around each call.
+	 */
+	struct Counters {
+		/**
+		 * \brief The number of heap allocations.
+		 */
+		std::uint64_t allocations = 0;
+
+		/**
+		 * \brief The number of \c read() and \c write() system calls made by
+		 *        the calling thread.
+		 */
+		std::uint64_t syscalls = 0;
+
+		/**
+		 * \brief The number of processes and threads created by the whole
+		 *        system.
+		 */
+		std::uint64_t forks = 0;
+	};
+
+#ifdef __linux__
+	/**
+	 * \brief  Reads a small procfs file into a static buffer, without
+	 *         allocating.
+	 * \param  path The path of the file.
+	 * \return The contents of the file, which stay valid until the next call.
+	 */
+	const char* readProc(const char* path) noexcept {
+		static char buffer[1 << 16];
+		buffer[0] = '\0';
+		const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0) return buffer;
+		const ssize_t got = ::read(fd, buffer, sizeof(buffer) - 1);
+		::close(fd);
+		buffer[got > 0 ? got : 0] = '\0';
+		return buffer;
+	}
+
+	/**
+	 * \brief  Finds a counter in a procfs file.
+	 * \param  text The contents of the file.
+	 * \param  key  The key before the counter, e.g. \c "processes ".
+	 * \return The counter, or \c 0 if it wasn't found.
+	 */
+	std::uint64_t findCounter(const char* text, const char* key) noexcept {
+		const char* found = std::strstr(text, key);
+		if (!found) return 0;
+		return std::strtoull(found + std::strlen(key), nullptr, 10);
+	}
+#endif
+
+	/**
+	 * \brief  Counts the resources used so far.
+	 * \return The counters.
+	 */
+	Counters count() noexcept {
+		Counters ret;
+#ifdef __linux__
+		ret.forks = findCounter(readProc("/proc/stat"), "processes ");
+		const char* io = readProc("/proc/thread-self/io");
+		ret.syscalls = findCounter(io, "syscr: ") + findCounter(io, "syscw: ");
+#endif
+		ret.allocations = allocations.load(std::memory_order_relaxed);
+		return ret;
+	}
+
+	/**
+	 * \brief   Counts the resources used since an earlier count.
+	 * \details The syscalls made by \c count() itself are subtracted.
+	 * \param   before The earlier count.
+	 * \return  The difference.
+	 */
+	Counters since(const Counters& before) noexcept {
+		const Counters after = count();
+		Counters ret;
+		ret.allocations = after.allocations - before.allocations;
+		// reading /proc/stat and /proc/thread-self/io costs one read each
+		ret.syscalls = after.syscalls - before.syscalls;
+		ret.syscalls = ret.syscalls >= 2 ? ret.syscalls - 2 : 0;
+		ret.forks = after.forks - before.forks;
+		return ret;
+	}
+
+	/**
+	 * \brief   A benchmark.
+	 * \details \c make is called outside of the measurements, and returns the
+	 *          call to measure. The first call of each returned function is
+	 *          measured as cold, and every call after that as warm.
+	 */
+	struct Benchmark {
+		/**
+		 * \brief The name of the benchmark.
+		 */
+		std::string name;
+
+		/**
+		 * \brief Creates the call to measure.
+		 */
+		std::function<std::function<void()>()> make;
+	};
+
+	/**
+	 * \brief The options given on the command line.
+	 */
+	struct Options {
+		std::filesystem::path root;
+		std::filesystem::path capture;
+		std::filesystem::path synthesize;
+		std::size_t cpus = 64;
+		std::size_t disks = 16;
+		std::size_t mounts = 32;
+		std::size_t interfaces = 8;
+		std::size_t cold = 20;
+		std::size_t warm = 10000;
+		std::chrono::milliseconds lifetime = std::chrono::milliseconds(1000);
+		std::size_t batch = 100000;
+		std::string filter;
+	};
+
+	/**
+	 * \brief  Creates a benchmark of a \c System::Properties accessor.
+	 * \param  name     The name of the benchmark.
+	 * \param  roots    The trees to read from.
+	 * \param  lifetime The volatile cache lifetime.
+	 * \param  call     Calls the accessor.
+	 * \return The benchmark.
+	 */
+	Benchmark accessor(const std::string& name, const System::Roots& roots,
+		const std::chrono::milliseconds lifetime,
+		const std::function<void(System::Properties&)>& call) {
+		return { name, [roots, lifetime, call]() {
+			auto properties = std::make_shared<System::Properties>(roots);
+			properties->setVolatileLifetime(lifetime);
+			return std::function<void()>([properties, call]() {
+				call(*properties);
+			});
+		} };
+	}
+
+	/**
+	 * \brief  Creates a benchmark of a probe which keeps state between calls,
+	 *         such as a sampler.
+	 * \param  name   The name of the benchmark.
+	 * \param  create Creates the state. This is part of the cold call.
+	 * \param  call   Calls the probe.
+	 * \return The benchmark.
+	 */
+	template<typename T>
+	Benchmark stateful(const std::string& name,
+		const std::function<std::unique_ptr<T>()>& create,
+		const std::function<void(T&)>& call) {
+		return { name, [create, call]() {
+			auto state = std::make_shared<std::unique_ptr<T>>();
+			return std::function<void()>([state, create, call]() {
+				if (!*state) *state = create();
+				call(**state);
+			});
+		} };
+	}
+
+	/**
+	 * \brief  Creates a benchmark of a probe which keeps no state.
+	 * \param  name The name of the benchmark.
+	 * \param  call Calls the probe.
+	 * \return The benchmark.
+	 */
+	Benchmark stateless(const std::string& name,
+		const std::function<void()>& call) {
+		return { name, [call]() { return call; } };
+	}
+
+	/**
+	 * \brief  Lists the benchmarks of every \c System::Properties accessor.
+	 * \param  roots    The trees to read from.
+	 * \param  lifetime The volatile cache lifetime.
+	 * \return The benchmarks.
+	 */
+	std::vector<Benchmark> accessors(const System::Roots& roots,
+		const std::chrono::milliseconds lifetime) {
+		using P = System::Properties&;
+		std::vector<Benchmark> ret;
+		const auto add = [&](const std::string& name,
+			const std::function<void(System::Properties&)>& call) {
+			ret.push_back(accessor(name, roots, lifetime, call));
+		};
+		add("CPUModel", [](P p) { p.CPUModel(); });
+		add("CPUArchitecture", [](P p) { p.CPUArchitecture(); });
+		add("CPUCapabilities", [](P p) { p.CPUCapabilities(); });
+		add("RAMTotal", [](P p) { p.RAMTotal(); });
+		add("RAMTotalBytes", [](P p) { p.RAMTotalBytes(); });
+		add("OSName", [](P p) { p.OSName(); });
+		add("OSVersion", [](P p) { p.OSVersion(); });
+#ifdef __linux__
+		add("OSDetails", [](P p) { p.OSDetails(); });
+#endif
+		add("GPUVendor", [](P p) { p.GPUVendor(); });
+		add("GPUName", [](P p) { p.GPUName(); });
+		add("GPUDriver", [](P p) { p.GPUDriver(); });
+		add("gpus", [](P p) { p.gpus(); });
+		add("cpuPackages", [](P p) { p.cpuPackages(); });
+		add("memoryModules", [](P p) { p.memoryModules(); });
+		add("disks", [](P p) { p.disks(); });
+		add("StorageTotal", [](P p) { p.StorageTotal(); });
+		add("StorageTotalBytes", [](P p) { p.StorageTotalBytes(); });
+		add("StorageFree", [](P p) { p.StorageFree(); });
+		add("StorageFreeBytes", [](P p) { p.StorageFreeBytes(); });
+		add("mounts", [](P p) { p.mounts(); });
+		add("mountOf", [](P p) { p.mountOf("/"); });
+		add("prefetchAll", [](P p) { p.prefetchAll().wait(); });
+		add("probeStats", [](P p) { p.probeStats(); });
+#ifdef __linux__
+		add("CPUSnapshot", [](P p) { p.CPUSnapshot(); });
+		add("CPULoad", [](P p) { p.CPULoad(); });
+		add("CPUTopology", [](P p) { p.CPUTopology(); });
+		add("RAMStats", [](P p) { p.RAMStats(); });
+		add("StorageLoad", [](P p) { p.StorageLoad(); });
+		add("NetworkInterfaces", [](P p) { p.NetworkInterfaces(); });
+		add("NetworkLoad", [](P p) { p.NetworkLoad(); });
+		add("process", [](P p) { p.process(); });
+		add("ResourceLimits", [](P p) { p.ResourceLimits(); });
+		add("EffectiveCPUCount", [](P p) { p.EffectiveCPUCount(); });
+		add("EffectiveRAMBytes", [](P p) { p.EffectiveRAMBytes(); });
+		add("Pressure", [](P p) { p.Pressure(); });
+		add("CgroupPressure", [](P p) { p.CgroupPressure(); });
+#endif
+		return ret;
+	}
+
+	/**
+	 * \brief   Serves canned WMI tables in place of \c IWbemServices, so that
+	 *          the batched query path can be measured on any platform.
+	 * \details It describes a machine with two CPU packages, eight RAM modules
+	 *          and four GPUs. Each query sleeps for a simulated round trip.
+	 */
+	class FakeWMI : public System::WMIBackend {
+	public:
+		/**
+		 * \brief The simulated cost of one query.
+		 */
+		static constexpr std::chrono::microseconds ROUND_TRIP{ 100 };
+
+		/**
+		 * \brief Fills the canned tables in.
+		 */
+		FakeWMI() {
+			for (int i = 0; i < 2; ++i) {
+				add("CIM_Processor", { { "Name", "Synthetic CPU" },
+					{ "AddressWidth", "64" } });
+			}
+			for (int i = 0; i < 8; ++i) {
+				add("CIM_PhysicalMemory", { { "Capacity", "17179869184" } });
+			}
+			add("Win32_OperatingSystem", { { "Caption", "Synthetic OS" },
+				{ "Version", "10.0.22631" } });
+			for (int i = 0; i < 4; ++i) {
+				add("Win32_VideoController", {
+					{ "AdapterCompatibility", "Synthetic Vendor" },
+					{ "Name", "Synthetic GPU " + std::to_string(i) },
+					{ "DriverVersion", "31.0.15.5222" } });
+			}
+		}
+
+		void execQuery(const std::string& className, const std::string&,
+			System::WMITable& out) override {
+			std::this_thread::sleep_for(ROUND_TRIP);
+			const auto instances = _classes.find(className);
+			if (instances == _classes.end()) {
+				throw std::system_error(std::error_code(ENOENT,
+					std::generic_category()), "Unknown WMI class " + className);
+			}
+			for (const auto& instance : instances->second) {
+				std::string* row = out.addRow();
+				for (std::size_t i = 0; i < out.columns().size(); ++i) {
+					const auto value = instance.find(out.columns()[i]);
+					if (value != instance.end()) row[i] = value->second;
+				}
+			}
+		}
+	private:
+		/**
+		 * \brief The properties of an instance, by name.
+		 */
+		typedef std::map<std::string, std::string> Instance;
+
+		/**
+		 * \brief Adds an instance of a class.
+		 * \param className The name of the class.
+		 * \param instance  The properties of the instance.
+		 */
+		void add(const std::string& className, Instance instance) {
+			_classes[className].push_back(std::move(instance));
+		}
+
+		/**
+		 * \brief The instances of each class.
+		 */
+		std::map<std::string, std::vector<Instance>> _classes;
+	};
+
+	/**
+	 * \brief   Reads every property the Windows accessors read, through a fresh
+	 *          client.
+	 * \param   batched \c TRUE to ask for each class's properties together, as
+	 *                  \c System::Properties does, or \c FALSE to query every
+	 *                  property separately, as it used to.
+	 */
+	void readWMI(const bool batched) {
+		System::WMIClient wmi(std::make_shared<FakeWMI>());
+		const auto select = [&](const char* className,
+			const std::initializer_list<std::string_view> properties) {
+			if (batched) {
+				wmi.select(className, properties);
+				return;
+			}
+			for (const std::string_view property : properties) {
+				wmi.invalidate();
+				wmi.select(className, { property });
+			}
+		};
+		select("CIM_Processor", { "Name", "AddressWidth" });
+		select("CIM_PhysicalMemory", { "Capacity" });
+		select("Win32_OperatingSystem", { "Caption", "Version" });
+		select("Win32_VideoController",
+			{ "AdapterCompatibility", "Name", "DriverVersion" });
+	}
+
+	/**
+	 * \brief  Lists the benchmarks of the WMI query layer, which run against
+	 *         \c FakeWMI on every platform.
+	 * \return The benchmarks.
+	 */
+	std::vector<Benchmark> wmi() {
+		return {
+			stateless("wmi:per-property", []() { readWMI(false); }),
+			stateless("wmi:batched", []() { readWMI(true); }),
+			stateful<System::WMIClient>("probe:WMIClient::select", []() {
+				return std::make_unique<System::WMIClient>(
+					std::make_shared<FakeWMI>());
+			}, [](System::WMIClient& c) {
+				c.select("Win32_VideoController", { "Name" });
+			}),
+		};
+	}
+
+#ifdef __linux__
+	/**
+	 * \brief  Lists the benchmarks of every probe which can be pointed at a
+	 *         fixture tree.
+	 * \param  root The root of the tree, containing \c proc and \c sys.
+	 * \return The benchmarks.
+	 */
+	std::vector<Benchmark> probes(const std::filesystem::path& root) {
+		const std::filesystem::path proc = root / "proc", sys = root / "sys";
+		const std::filesystem::path mountinfo = (root == "/" ?
+			System::Roots() : System::Roots::under(root)).mountinfo();
+		System::MountOptions serial;
+		serial.parallel = false;
+		return {
+			stateless("probe:CPUInfo::load",
+				[proc]() { System::CPUInfo::load(proc / "cpuinfo"); }),
+			stateless("probe:Topology::load",
+				[sys]() { System::Topology::load(sys); }),
+			stateless("probe:enumerateGPUs",
+				[sys]() { System::enumerateGPUs(sys); }),
+			stateless("probe:enumerateMounts", [mountinfo, serial]() {
+				System::enumerateMounts(serial, mountinfo);
+			}),
+			stateful<System::MemorySampler>("probe:MemorySampler",
+				[proc]() {
+					return std::make_unique<System::MemorySampler>(
+						proc / "meminfo");
+				}, [](System::MemorySampler& s) { s.sample(); }),
+			stateful<System::CPUSampler>("probe:CPUSampler",
+				[proc, sys]() {
+					return std::make_unique<System::CPUSampler>(proc, sys);
+				}, [](System::CPUSampler& s) { s.sample(); }),
+			stateful<System::DiskSampler>("probe:DiskSampler",
+				[proc]() {
+					return std::make_unique<System::DiskSampler>(proc);
+				}, [](System::DiskSampler& s) { s.sample(); }),
+			stateless("probe:enumerateNetworkInterfaces",
+				[sys]() { System::enumerateNetworkInterfaces(sys, false); }),
+			stateful<System::NetworkSampler>("probe:NetworkSampler",
+				[proc]() {
+					return std::make_unique<System::NetworkSampler>(proc);
+				}, [](System::NetworkSampler& s) { s.sample(); }),
+			stateless("probe:enumerateDisks",
+				[sys]() { System::enumerateDisks(sys); }),
+			stateless("probe:enumerateMemoryModules",
+				[sys]() { System::enumerateMemoryModules(sys); }),
+			stateless("probe:CgroupLimits::load",
+				[proc, root]() { System::CgroupLimits::load(proc, root); }),
+			stateful<System::ProcessSampler>("probe:ProcessSampler",
+				[proc]() {
+					return std::make_unique<System::ProcessSampler>(proc);
+				}, [](System::ProcessSampler& s) {
+					System::ProcessStats stats;
+					s.sample(0, stats);
+				}),
+			stateful<System::ProcessSampler>("probe:ProcessSampler::scan",
+				[proc]() {
+					return std::make_unique<System::ProcessSampler>(proc);
+				}, [](System::ProcessSampler& s) {
+					static std::vector<System::ProcessStats> stats;
+					s.scan(stats);
+				}),
+		};
+	}
+
+	/**
+	 * \brief Copies a file, reading until EOF because procfs and sysfs files
+	 *        report the wrong size.
+	 * \param live The path of the live file.
+	 * \param copy The path of the copy.
+	 */
+	void copyFile(const std::filesystem::path& live,
+		const std::filesystem::path& copy) {
+		std::ifstream in(live, std::ios::binary);
+		if (!in.good()) return;
+		std::error_code err;
+		std::filesystem::create_directories(copy.parent_path(), err);
+		std::ofstream(copy, std::ios::binary) << in.rdbuf();
+	}
+
+	/**
+	 * \brief  Copies a live file into a fixture tree, recreating every symlink
+	 *         on its path so that the tree resolves the same way.
+	 * \param  live The path of the live file or directory.
+	 * \param  root The root of the fixture tree.
+	 */
+	void capture(const std::filesystem::path& live,
+		const std::filesystem::path& root) {
+		std::error_code err;
+		std::filesystem::path current = live.root_path();
+		for (auto it = live.begin(); it != live.end(); ++it) {
+			if (*it == live.root_path() || it->empty()) continue;
+			const std::filesystem::path next = current / *it;
+			if (std::filesystem::is_symlink(next, err)) {
+				const auto target = std::filesystem::read_symlink(next, err);
+				const auto copy = root / next.relative_path();
+				std::filesystem::create_directories(copy.parent_path(), err);
+				std::filesystem::create_symlink(target, copy, err);
+				std::filesystem::path rest = target.is_absolute() ? target :
+					(current / target).lexically_normal();
+				for (++it; it != live.end(); ++it) rest /= *it;
+				capture(rest, root);
+				return;
+			}
+			current = next;
+		}
+		const auto copy = root / current.relative_path();
+		if (std::filesystem::is_directory(current, err)) {
+			std::filesystem::create_directories(copy, err);
+			return;
+		}
+		copyFile(current, copy);
+	}
+
+	/**
+	 * \brief Copies every live file the probes read into a fixture tree.
+	 * \param root The root of the fixture tree.
+	 */
+	void captureAll(const std::filesystem::path& root) {
+		for (const char* file : { "/proc/cpuinfo", "/proc/meminfo",
+			"/proc/stat", "/proc/diskstats", "/proc/sys/kernel/ostype",
+			"/proc/sys/kernel/osrelease", "/proc/sys/kernel/version" }) {
+			capture(file, root);
+		}
+		// the mount queries read PID 1's mounts in a fixture, whilst the cgroup
+		// limits read this process'; don't follow /proc/self for either
+		for (const char* pid : { "1", "self" }) {
+			copyFile("/proc/self/mountinfo", root / "proc" / pid / "mountinfo");
+		}
+		copyFile("/proc/net/dev", root / "proc" / "net" / "dev");
+		// os-release is usually a relative symlink into /usr/lib
+		copyFile("/etc/os-release", root / "etc" / "os-release");
+		std::error_code err;
+		const std::filesystem::path cpus = "/sys/devices/system/cpu";
+		capture(cpus / "online", root);
+		for (std::filesystem::directory_iterator it(cpus, err), end;
+			!err && it != end; it.increment(err)) {
+			const auto dir = it->path();
+			capture(dir / "cpufreq" / "scaling_cur_freq", root);
+			for (const char* file : { "physical_package_id", "core_id",
+				"thread_siblings_list" }) {
+				capture(dir / "topology" / file, root);
+			}
+			std::error_code cacheErr;
+			for (std::filesystem::directory_iterator cache(dir / "cache",
+				cacheErr); !cacheErr && cache != end;
+				cache.increment(cacheErr)) {
+				for (const char* file : { "level", "type", "size",
+					"coherency_line_size", "shared_cpu_list" }) {
+					capture(cache->path() / file, root);
+				}
+			}
+		}
+		const std::filesystem::path nodes = "/sys/devices/system/node";
+		capture(nodes / "online", root);
+		for (std::filesystem::directory_iterator it(nodes, err), end;
+			!err && it != end; it.increment(err)) {
+			capture(it->path() / "cpulist", root);
+			capture(it->path() / "meminfo", root);
+		}
+		err.clear();
+		for (std::filesystem::directory_iterator it("/sys/bus/pci/devices",
+			err), end; !err && it != end; it.increment(err)) {
+			for (const char* file : { "class", "vendor", "device",
+				"boot_vga" }) {
+				capture(it->path() / file, root);
+			}
+			capture(it->path() / "driver" / "module", root);
+			std::error_code linkErr;
+			const auto module = std::filesystem::read_symlink(it->path() /
+				"driver" / "module", linkErr);
+			if (!linkErr) {
+				capture(std::filesystem::path("/sys/module") /
+					module.filename() / "version", root);
+			}
+		}
+		err.clear();
+		for (std::filesystem::directory_iterator it("/sys/block", err), end;
+			!err && it != end; it.increment(err)) {
+			for (const char* file : { "size", "removable", "device/model" }) {
+				capture(it->path() / file, root);
+			}
+		}
+		// the SMBIOS tables can only be captured by root
+		err.clear();
+		for (std::filesystem::directory_iterator it("/sys/firmware/dmi/entries",
+			err), end; !err && it != end; it.increment(err)) {
+			if (it->path().filename().string().compare(0, 3, "17-") == 0) {
+				capture(it->path() / "raw", root);
+			}
+		}
+	}
+
+	/**
+	 * \brief Writes a file into a fixture tree, creating its directories.
+	 * \param path The path of the file.
+	 * \param text The contents of the file.
+	 */
+	void write(const std::filesystem::path& path, const std::string& text) {
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream(path, std::ios::binary) << text;
+	}
+
+	/**
+	 * \brief   Writes a synthetic fixture tree.
+	 * \details The machine has two packages with two threads per core, one
+	 *          NUMA node per package, and a private L1 and L2 per core and a
+	 *          shared L3 per package. Every other one of its sixteen RAM slots
+	 *          holds a 16GB module.
+	 * \param   root    The root of the fixture tree.
+	 * \param   options The sizes of the machine.
+	 */
+	void synthesize(const std::filesystem::path& root, const Options& options) {
+		const std::filesystem::path proc = root / "proc", sys = root / "sys";
+		const std::size_t n = std::max<std::size_t>(options.cpus, 4) / 4 * 4;
+		const std::size_t perPackage = n / 2;
+		const auto range = [](std::size_t first, std::size_t last) {
+			return std::to_string(first) + "-" + std::to_string(last);
+		};
+
+		std::string cpuinfo, stat = "cpu  100 0 100 10000 10 0 0 0 0 0\n";
+		for (std::size_t cpu = 0; cpu < n; ++cpu) {
+			const std::size_t package = cpu / perPackage;
+			const std::size_t core = cpu % perPackage / 2;
+			cpuinfo += "processor\t: " + std::to_string(cpu) + "\n"
+				"vendor_id\t: GenuineIntel\n"
+				"model name\t: Synthetic CPU @ 2.00GHz\n"
+				"physical id\t: " + std::to_string(package) + "\n"
+				"core id\t\t: " + std::to_string(core) + "\n"
+				"flags\t\t: fpu vme de pse tsc msr pae mce cx8 apic sse2\n\n";
+			stat += "cpu" + std::to_string(cpu) + " 10 0 10 1000 1 0 0 0 0 0\n";
+
+			const auto dir = sys / "devices" / "system" / "cpu" /
+				("cpu" + std::to_string(cpu));
+			const std::size_t sibling = cpu - cpu % 2;
+			write(dir / "topology" / "physical_package_id",
+				std::to_string(package) + "\n");
+			write(dir / "topology" / "core_id", std::to_string(core) + "\n");
+			write(dir / "topology" / "thread_siblings_list",
+				range(sibling, sibling + 1) + "\n");
+			write(dir / "cpufreq" / "scaling_cur_freq", "2000000\n");
+			const char* caches[][3] = { { "1", "Data", "48K" },
+				{ "1", "Instruction", "32K" }, { "2", "Unified", "2048K" },
+				{ "3", "Unified", "32768K" } };
+			for (std::size_t i = 0; i < 4; ++i) {
+				const auto index = dir / "cache" /
+					("index" + std::to_string(i));
+				write(index / "level", std::string(caches[i][0]) + "\n");
+				write(index / "type", std::string(caches[i][1]) + "\n");
+				write(index / "size", std::string(caches[i][2]) + "\n");
+				write(index / "coherency_line_size", "64\n");
+				const std::size_t first = package * perPackage;
+				write(index / "shared_cpu_list", (i == 3 ?
+					range(first, first + perPackage - 1) :
+					range(sibling, sibling + 1)) + "\n");
+			}
+		}
+		stat += "intr 0\nctxt 0\nbtime 0\nprocesses 0\nprocs_running 1\n";
+		write(proc / "cpuinfo", cpuinfo);
+		write(proc / "sys" / "kernel" / "ostype", "Linux\n");
+		write(proc / "sys" / "kernel" / "osrelease", "6.1.0-synthetic\n");
+		write(proc / "sys" / "kernel" / "version", "#1 SMP PREEMPT_DYNAMIC\n");
+		write(root / "etc" / "os-release",
+			"PRETTY_NAME=\"Synthetic Linux 1.0\"\nNAME=\"Synthetic Linux\"\n"
+			"VERSION_ID=\"1.0\"\nID=synthetic\nID_LIKE=\"debian\"\n");
+		write(proc / "stat", stat);
+		write(sys / "devices" / "system" / "cpu" / "online",
+			range(0, n - 1) + "\n");
+		write(sys / "devices" / "system" / "node" / "online", "0-1\n");
+		for (std::size_t node = 0; node < 2; ++node) {
+			const auto dir = sys / "devices" / "system" / "node" /
+				("node" + std::to_string(node));
+			write(dir / "cpulist", range(node * perPackage,
+				(node + 1) * perPackage - 1) + "\n");
+			write(dir / "meminfo", "Node " + std::to_string(node) +
+				" MemTotal:       67108864 kB\n");
+		}
+
+		write(proc / "meminfo", "MemTotal:       134217728 kB\n"
+			"MemFree:        67108864 kB\nMemAvailable:   100663296 kB\n"
+			"Buffers:         1048576 kB\nCached:         16777216 kB\n"
+			"SwapCached:            0 kB\nActive:         33554432 kB\n"
+			"Inactive:       16777216 kB\nSwapTotal:       8388608 kB\n"
+			"SwapFree:        8388608 kB\nDirty:               128 kB\n"
+			"Writeback:             0 kB\nAnonPages:      25165824 kB\n"
+			"Mapped:          2097152 kB\nShmem:            524288 kB\n"
+			"Slab:            4194304 kB\nSReclaimable:    3145728 kB\n"
+			"SUnreclaim:      1048576 kB\nPageTables:       262144 kB\n"
+			"CommitLimit:    75497472 kB\nCommitted_AS:   50331648 kB\n"
+			"HugePages_Total:       0\nHugePages_Free:        0\n"
+			"Hugepagesize:       2048 kB\n");
+
+		std::string diskstats, mountinfo;
+		for (std::size_t disk = 0; disk < options.disks; ++disk) {
+			diskstats += "   8 " + std::to_string(disk * 16) + " sd" +
+				static_cast<char>('a' + disk % 26) +
+				(disk >= 26 ? std::to_string(disk / 26) : std::string()) +
+				" 4363 1287 261506 1604 1019 4052 40424 2010 0 2204 3614"
+				" 0 0 0 0 120 43\n";
+		}
+		for (std::size_t mount = 0; mount < options.mounts; ++mount) {
+			const std::string id = std::to_string(100 + mount);
+			const std::size_t disk = options.disks ? mount % options.disks : 0;
+			mountinfo += id + " 1 8:" + std::to_string(disk * 16) + " / " +
+				(mount ? "/mnt/volume" + std::to_string(mount) : "/") +
+				" rw,relatime shared:1 - ext4 /dev/sd" +
+				static_cast<char>('a' + disk % 26) + " rw\n";
+		}
+		write(proc / "diskstats", diskstats);
+		write(proc / "1" / "mountinfo", mountinfo);
+		write(proc / "self" / "mountinfo", mountinfo);
+		for (std::size_t disk = 0; disk < options.disks; ++disk) {
+			const std::filesystem::path dir = sys / "block" / ("sd" +
+				std::string(1, static_cast<char>('a' + disk % 26)) +
+				(disk >= 26 ? std::to_string(disk / 26) : std::string()));
+			write(dir / "size", "1953525168\n");
+			write(dir / "removable", "0\n");
+			write(dir / "device" / "model", "Synthetic SSD\n");
+		}
+
+		// one SMBIOS memory device per slot, with every other slot empty
+		for (std::size_t slot = 0; slot < 16; ++slot) {
+			std::string raw(0x28, '\0');
+			raw[0] = 17;
+			raw[1] = 0x28;
+			if (slot % 2 == 0) {
+				raw[0x0C] = 0x00;
+				raw[0x0D] = 0x40;
+				raw[0x12] = 0x1A;
+				raw[0x15] = static_cast<char>(3200 & 0xFF);
+				raw[0x16] = static_cast<char>(3200 >> 8);
+				raw[0x17] = 3;
+				raw[0x1A] = 4;
+			}
+			raw[0x10] = 1;
+			raw[0x11] = 2;
+			raw += "DIMM_" + std::to_string(slot) + '\0' + "BANK " +
+				std::to_string(slot / 2) + '\0' + "Synthetic" + '\0' +
+				"SYN-16G-3200   " + '\0' + '\0';
+			write(sys / "firmware" / "dmi" / "entries" /
+				("17-" + std::to_string(slot)) / "raw", raw);
+		}
+
+		std::string netdev = "Inter-|   Receive                            "
+			"                    |  Transmit\n face |bytes    packets errs drop"
+			" fifo frame compressed multicast|bytes    packets errs drop fifo "
+			"colls carrier compressed\n";
+		for (std::size_t i = 0; i < options.interfaces; ++i) {
+			const std::string name = i ? "eth" + std::to_string(i - 1) : "lo";
+			netdev += "  " + name + ": 53336511 5950 0 0 0 0 0 0 53336511 "
+				"5950 0 0 0 0 0 0\n";
+			const std::filesystem::path dir = sys / "class" / "net" / name;
+			write(dir / "address", i ? "52:54:00:12:34:" +
+				std::to_string(10 + i % 90) + "\n" : "00:00:00:00:00:00\n");
+			write(dir / "mtu", i ? "1500\n" : "65536\n");
+			write(dir / "speed", i ? "10000\n" : "-1\n");
+			write(dir / "flags", i ? "0x1003\n" : "0x9\n");
+		}
+		write(proc / "net" / "dev", netdev);
+	}
+#endif
+
+	/**
+	 * \brief  Finds the median of some measurements.
+	 * \param  values The measurements. They are reordered.
+	 * \return The median, or \c 0 if there are none.
+	 */
+	double median(std::vector<double>& values) {
+		if (values.empty()) return 0.0;
+		std::nth_element(values.begin(), values.begin() + values.size() / 2,
+			values.end());
+		return values[values.size() / 2];
+	}
+
+	/**
+	 * \brief  Runs a benchmark and prints one row of results.
+	 * \param  benchmark The benchmark to run.
+	 * \param  options   The number of runs.
+	 */
+	void run(const Benchmark& benchmark, const Options& options) {
+		using clock = std::chrono::steady_clock;
+		const auto call = [](const std::function<void()>& f) {
+			try {
+				f();
+				return true;
+			} catch (const std::exception&) {
+				return false;
+			}
+		};
+
+		// cold: a fresh object for every run
+		std::vector<double> cold;
+		Counters coldCounters{ UINT64_MAX, UINT64_MAX, UINT64_MAX };
+		bool failed = false;
+		for (std::size_t i = 0; i < options.cold; ++i) {
+			const std::function<void()> f = benchmark.make();
+			const Counters before = count();
+			const auto start = clock::now();
+			failed |= !call(f);
+			const auto end = clock::now();
+			const Counters used = since(before);
+			cold.push_back(std::chrono::duration<double, std::micro>(
+				end - start).count());
+			coldCounters.allocations = std::min(coldCounters.allocations,
+				used.allocations);
+			coldCounters.syscalls = std::min(coldCounters.syscalls,
+				used.syscalls);
+			coldCounters.forks = std::min(coldCounters.forks, used.forks);
+		}
+
+		// warm: one object, called once before measuring
+		const std::function<void()> f = benchmark.make();
+		call(f);
+		const Counters before = count();
+		const auto start = clock::now();
+		for (std::size_t i = 0; i < options.warm; ++i) call(f);
+		const auto end = clock::now();
+		const Counters used = since(before);
+		const double calls = static_cast<double>(std::max<std::size_t>(
+			options.warm, 1));
+
+		const double warm = std::chrono::duration<double, std::nano>(
+			end - start).count() / calls;
+		std::printf("%-24s %12.1f %12.1f %10llu %10.2f %10llu %10.2f %6llu"
+			" %s\n",
+			benchmark.name.c_str(), median(cold), warm,
+			static_cast<unsigned long long>(coldCounters.allocations),
+			used.allocations / calls,
+			static_cast<unsigned long long>(coldCounters.syscalls),
+			used.syscalls / calls,
+			static_cast<unsigned long long>(coldCounters.forks),
+			failed ? "(threw)" : "");
+	}
+
+	/**
+	 * \brief   Measures the throughput of encoding, decoding and formatting a
+	 *          batch of snapshots, and prints one row per operation.
+	 * \details The batch is made of variations of one snapshot of the live
+	 *          system, so that every property is present.
+	 * \param   options The size of the batch.
+	 */
+	void runSnapshots(const Options& options) {
+		using clock = std::chrono::steady_clock;
+		System::Snapshot base;
+		try {
+			base = System::Properties().snapshot();
+		} catch (const std::exception&) {}
+		for (unsigned i = 0; i <= static_cast<unsigned>(
+			System::Property::StorageFree); ++i) {
+			base.set(static_cast<System::Property>(i));
+		}
+		std::vector<System::Snapshot> batch(std::max<std::size_t>(
+			options.batch, 1), base);
+		for (std::size_t i = 0; i < batch.size(); ++i) {
+			batch[i].GPUName = "Synthetic GPU " + std::to_string(i % 64);
+			batch[i].StorageFree = base.StorageTotal / (i % 7 + 1);
+		}
+
+		const auto report = [&](const char* name, const clock::duration time,
+			const std::size_t bytes, const std::uint64_t allocs) {
+			const double seconds = std::chrono::duration<double>(time).count();
+			std::printf("%-24s %12.0f %12.1f %12.2f\n", name,
+				batch.size() / seconds, bytes / seconds / 1e6,
+				static_cast<double>(allocs) / batch.size());
+		};
+		std::printf("\n%-24s %12s %12s %12s\n", "snapshot batch",
+			"snapshots/s", "MB/s", "allocs/snap");
+
+		std::string encoded;
+		Counters before = count();
+		auto start = clock::now();
+		for (const auto& snapshot : batch) snapshot.encode(encoded);
+		report("snapshot:encode", clock::now() - start, encoded.size(),
+			since(before).allocations);
+
+		std::size_t decoded = 0;
+		before = count();
+		start = clock::now();
+		std::string_view rest = encoded;
+		System::SnapshotView view;
+		while (const std::size_t used = System::decodeSnapshot(rest, view)) {
+			rest.remove_prefix(used);
+			++decoded;
+		}
+		report("snapshot:decode", clock::now() - start, encoded.size(),
+			since(before).allocations);
+		if (decoded != batch.size()) {
+			std::printf("decoded %zu of %zu snapshots\n", decoded,
+				batch.size());
+		}
+
+		std::size_t json = 0;
+		before = count();
+		start = clock::now();
+		for (const auto& snapshot : batch) json += snapshot.json().size();
+		report("snapshot:json", clock::now() - start, json,
+			since(before).allocations);
+	}
+
+#ifdef __linux__
+	/**
+	 * \brief   Parses \c /proc/cpuinfo with \c std::getline() and a string per
+	 *          key and value, as a baseline for \c System::CPUInfo::parse().
+	 * \details Like the library, this splits the text into one table per
+	 *          block and keeps the fields shared by each package's CPUs.
+	 * \param   text The contents of the file.
+	 * \return  The number of packages found.
+	 */
+	std::size_t getlineCPUInfo(const std::string& text) {
+		using Fields = System::CPUInfo::Fields;
+		const auto trim = [](const std::string& str) {
+			const std::size_t first = str.find_first_not_of(" \t");
+			if (first == std::string::npos) return std::string();
+			return str.substr(first, str.find_last_not_of(" \t") - first + 1);
+		};
+		std::istringstream in(text);
+		std::vector<Fields> blocks(1);
+		std::string line;
+		while (std::getline(in, line)) {
+			const std::size_t colon = line.find(':');
+			if (colon == std::string::npos) {
+				if (!blocks.back().empty()) blocks.emplace_back();
+				continue;
+			}
+			blocks.back().emplace(trim(line.substr(0, colon)),
+				trim(line.substr(colon + 1)));
+		}
+		std::map<unsigned long, std::vector<std::size_t>> packages;
+		for (std::size_t i = 0; i < blocks.size(); ++i) {
+			const auto id = blocks[i].find("physical id");
+			packages[id == blocks[i].end() ? 0 :
+				std::stoul(id->second)].push_back(i);
+		}
+		std::vector<Fields> shared;
+		for (const auto& package : packages) {
+			Fields fields = blocks[package.second.front()];
+			for (const auto i : package.second) {
+				for (auto field = fields.begin(); field != fields.end();) {
+					const auto other = blocks[i].find(field->first);
+					if (other == blocks[i].end() ||
+						other->second != field->second) {
+						field = fields.erase(field);
+					} else {
+						++field;
+					}
+				}
+			}
+			shared.push_back(std::move(fields));
+		}
+		return shared.size();
+	}
+
+	/**
+	 * \brief  Parses \c /proc/meminfo with \c std::getline() and
+	 *         \c std::stoull(), as a baseline for
+	 *         \c System::MemoryStats::parse().
+	 * \param  text The contents of the file.
+	 * \return The sum of the values parsed.
+	 */
+	std::uint64_t getlineMemInfo(const std::string& text) {
+		std::istringstream in(text);
+		std::string line;
+		std::uint64_t sum = 0;
+		while (std::getline(in, line)) {
+			const std::size_t colon = line.find(':');
+			if (colon == std::string::npos) continue;
+			const std::string key = line.substr(0, colon);
+			if (key == "MemTotal" || key == "MemFree" || key == "Cached") {
+				sum += std::stoull(line.substr(colon + 1));
+			}
+		}
+		return sum;
+	}
+
+	/**
+	 * \brief  Parses the CPU lines of \c /proc/stat with \c std::getline()
+	 *         and \c std::istringstream, as a baseline for
+	 *         \c System::CPUSampler::sample().
+	 * \param  text The contents of the file.
+	 * \return The sum of the counters parsed.
+	 */
+	std::uint64_t getlineStat(const std::string& text) {
+		std::istringstream in(text);
+		std::string line, name;
+		std::uint64_t sum = 0;
+		while (std::getline(in, line) && line.compare(0, 3, "cpu") == 0) {
+			std::istringstream fields(line);
+			fields >> name;
+			std::uint64_t value = 0;
+			for (int i = 0; i < 8 && fields >> value; ++i) sum += value;
+		}
+		return sum;
+	}
+
+	/**
+	 * \brief  Parses \c /proc/self/mountinfo with \c std::getline() and
+	 *         \c std::istringstream, as a baseline for
+	 *         \c System::parseMountInfo().
+	 * \param  text The contents of the file.
+	 * \return The mounts parsed.
+	 */
+	std::vector<System::Mount> getlineMountInfo(const std::string& text) {
+		std::istringstream in(text);
+		std::vector<System::Mount> ret;
+		std::string line;
+		while (std::getline(in, line)) {
+			std::istringstream fields(line);
+			std::string id, parent, device, field;
+			System::Mount mount;
+			fields >> id >> parent >> device >> mount.root >>
+				mount.mountPoint >> mount.options;
+			while (fields >> field && field != "-") {}
+			fields >> mount.fsType >> mount.source;
+			ret.push_back(std::move(mount));
+		}
+		return ret;
+	}
+
+	/**
+	 * \brief   Measures the throughput of the procfs parsers against
+	 *          \c std::getline() baselines, and prints one row per parser.
+	 * \details Each file is read from the fixture tree, or the live system,
+	 *          and repeated until it is at least 4MB long. \c /proc/stat is
+	 *          parsed by a \c System::CPUSampler, which reads a temporary copy.
+	 * \param   options The fixture tree and the filter.
+	 */
+	void runParsers(const Options& options) {
+		using clock = std::chrono::steady_clock;
+		const System::Roots roots = options.root.empty() ? System::Roots() :
+			System::Roots::under(options.root);
+		const std::filesystem::path& proc = roots.proc;
+		const auto load = [&](const std::filesystem::path& path) {
+			std::ifstream file(path, std::ios::binary);
+			std::ostringstream contents;
+			contents << file.rdbuf();
+			const std::string once = contents.str();
+			std::string text;
+			while (!once.empty() && text.size() < (4u << 20)) text += once;
+			return text;
+		};
+		const std::string cpuinfo = load(proc / "cpuinfo"),
+			meminfo = load(proc / "meminfo"),
+			mountinfo = load(roots.mountinfo());
+		// the sampler stops at the first line which isn't a CPU's, so only the
+		// CPU lines are repeated, into a file of its own
+		std::string stat;
+		{
+			std::ifstream file(proc / "stat", std::ios::binary);
+			std::string line, once;
+			while (std::getline(file, line) && line.compare(0, 3, "cpu") == 0) {
+				once += line + '\n';
+			}
+			while (!once.empty() && stat.size() < (4u << 20)) stat += once;
+		}
+		const std::filesystem::path statRoot =
+			std::filesystem::temp_directory_path() /
+			("SystemPropertiesBenchmark." + std::to_string(::getpid()));
+		std::unique_ptr<System::CPUSampler> sampler;
+		if (!stat.empty()) {
+			write(statRoot / "stat", stat);
+			sampler = std::make_unique<System::CPUSampler>(statRoot, statRoot,
+				false);
+		}
+
+		bool header = false;
+		const auto measure = [&](const char* name, const std::string& text,
+			const std::function<void()>& parse) {
+			if (std::string(name).find(options.filter) == std::string::npos) {
+				return;
+			}
+			if (!header) {
+				std::printf("\n%-24s %12s %12s\n", "parser", "MB/s",
+					"allocs/pass");
+				header = true;
+			}
+			if (text.empty()) {
+				std::printf("%-24s %12s\n", name, "(no file)");
+				return;
+			}
+			constexpr int PASSES = 10;
+			parse();
+			const Counters before = count();
+			const auto start = clock::now();
+			for (int i = 0; i < PASSES; ++i) parse();
+			const double seconds = std::chrono::duration<double>(
+				clock::now() - start).count();
+			std::printf("%-24s %12.1f %12.1f\n", name,
+				text.size() * PASSES / seconds / 1e6,
+				static_cast<double>(since(before).allocations) / PASSES);
+		};
+		System::MemoryStats stats;
+		measure("parse:cpuinfo", cpuinfo,
+			[&]() { System::CPUInfo::parse(cpuinfo); });
+		measure("parse:cpuinfo (getline)", cpuinfo,
+			[&]() { getlineCPUInfo(cpuinfo); });
+		measure("parse:meminfo", meminfo,
+			[&]() { System::MemoryStats::parse(meminfo, stats); });
+		measure("parse:meminfo (getline)", meminfo,
+			[&]() { getlineMemInfo(meminfo); });
+		measure("parse:mountinfo", mountinfo,
+			[&]() { System::parseMountInfo(mountinfo); });
+		measure("parse:mountinfo (getline)", mountinfo,
+			[&]() { getlineMountInfo(mountinfo); });
+		measure("parse:stat", stat, [&]() { sampler->sample(); });
+		measure("parse:stat (getline)", stat, [&]() { getlineStat(stat); });
+		std::error_code err;
+		std::filesystem::remove_all(statRoot, err);
+	}
+#endif
+
+	/**
+	 * \brief  Parses the command line.
+	 * \param  argc The number of arguments.
+	 * \param  argv The arguments.
+	 * \return The options.
+	 * \throws std::invalid_argument if an argument is unknown or malformed.
+	 */
+	Options parse(const int argc, char* argv[]) {
+		Options ret;
+		for (int i = 1; i < argc; ++i) {
+			const std::string arg = argv[i];
+			if (i + 1 >= argc) {
+				throw std::invalid_argument("Missing value for " + arg);
+			}
+			const std::string value = argv[++i];
+			if (arg == "--root") ret.root = value;
+			else if (arg == "--capture") ret.capture = value;
+			else if (arg == "--synthesize") ret.synthesize = value;
+			else if (arg == "--cpus") ret.cpus = std::stoul(value);
+			else if (arg == "--disks") ret.disks = std::stoul(value);
+			else if (arg == "--mounts") ret.mounts = std::stoul(value);
+			else if (arg == "--interfaces") {
+				ret.interfaces = std::stoul(value);
+			}
+			else if (arg == "--cold") ret.cold = std::stoul(value);
+			else if (arg == "--warm") ret.warm = std::stoul(value);
+			else if (arg == "--batch") ret.batch = std::stoul(value);
+			else if (arg == "--lifetime") {
+				ret.lifetime = std::chrono::milliseconds(std::stoul(value));
+			} else if (arg == "--filter") ret.filter = value;
+			else throw std::invalid_argument("Unknown option " + arg);
+		}
+		return ret;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	try {
+		options = parse(argc, argv);
+#ifdef __linux__
+		if (!options.capture.empty()) {
+			captureAll(options.capture);
+			std::cout << "Captured the live system into " << options.capture
+				<< std::endl;
+			return 0;
+		}
+		if (!options.synthesize.empty()) {
+			synthesize(options.synthesize, options);
+			std::cout << "Wrote a synthetic tree into " << options.synthesize
+				<< std::endl;
+			return 0;
+		}
+#endif
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	const System::Roots roots = options.root.empty() ? System::Roots() :
+		System::Roots::under(options.root);
+	std::vector<Benchmark> benchmarks = accessors(roots, options.lifetime);
+	for (auto& benchmark : wmi()) benchmarks.push_back(std::move(benchmark));
+#ifdef __linux__
+	for (auto& probe : probes(options.root.empty() ? "/" : options.root)) {
+		benchmarks.push_back(std::move(probe));
+	}
+#else
+	if (!options.root.empty()) {
+		std::cerr << "Fixture trees are only supported on Linux" << std::endl;
+		return 1;
+	}
+#endif
+
+	std::printf("%-24s %12s %12s %10s %10s %10s %10s %6s\n", "benchmark",
+		"cold (us)", "warm (ns)", "cold alloc", "warm alloc", "cold sys",
+		"warm sys", "forks");
+	for (const auto& benchmark : benchmarks) {
+		if (benchmark.name.find(options.filter) == std::string::npos) continue;
+		run(benchmark, options);
+	}
+	const std::string snapshots =
+		"snapshot:encode snapshot:decode snapshot:json";
+	if (snapshots.find(options.filter) != std::string::npos) {
+		runSnapshots(options);
+	}
+#ifdef __linux__
+	runParsers(options);
+#endif
+	return 0;
+}